@@ -0,0 +1,62 @@
+//============================================================================================
+//
+// File Name    : cascade_convert.cpp
+// Description  : Converter of Haar cascades to binary cascade files (.hcb)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  .dat tables, class.txt and OpenCV XML to .hcb
+//============================================================================================
+
+/****************************************************************
+ * Writes the layout of a cascade as a binary cascade file, which
+ * facedetect_host.exe -a and mapCascadeFile use in place:
+ *
+ *   cascade_convert.exe face.hcb                    the .dat tables
+ *   cascade_convert.exe Comashi_original/class.txt face.hcb
+ *   cascade_convert.exe haarcascade_frontalface_default.xml face.hcb
+ ***************************************************************/
+
+#include "cascade_layout.h"
+#include <stdio.h>
+
+int main(int argc, char** argv)
+{
+    HaarCascade cascade;
+    CascadeLayout* layout;
+    const char* output;
+
+    if( argc != 2 && argc != 3 )
+    {
+        printf("usage: cascade_convert.exe [cascade] output.hcb\n");
+        printf("  cascade: OpenCV Haar .xml, or class.txt with info.txt in the same directory (default the built-in .dat tables)\n");
+        return 1;
+    }
+    output = argv[argc-1];
+
+    if( argc == 3 )
+    {
+        if( loadCascade(argv[1], &cascade) < 0 || checkCascade(cascade) < 0 )
+            return 1;
+        layout = buildCascadeLayout(cascade);
+    }
+    else
+    {
+        layout = buildCascadeLayout(builtinCascade());
+    }
+    if( layout == NULL )
+        return 1;
+
+    if( writeCascadeFile(output, layout) < 0 )
+    {
+        delete layout;
+        return 1;
+    }
+    printf("%s: %d stages, %d features evaluated, %d bytes\n", output, layout->nstages, layout->count, (int)layout->image_size);
+    delete layout;
+    return 0;
+}
@@ -0,0 +1,463 @@
+//============================================================================================
+//
+// File Name    : cascade_layout.cpp
+// Description  : Cascade tables in the order of the host engines, and their binary file
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Layout out of facedetect_host.cpp, mapped cascade files
+//============================================================================================
+
+#include "define.h"
+#include "cascade_layout.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* the tables of a layout while it is built */
+struct LayoutTables
+{
+    std::vector<int> stage_features;
+    std::vector<int> stage_two_rect;
+    std::vector<int> stage_thresh;
+    std::vector<int> stage_limit;
+    std::vector<int> stage_corners;
+    std::vector<int> rectangles;
+    std::vector<int> weights;
+    std::vector<int> tree_thresh;
+    std::vector<int> alpha1;
+    std::vector<int> alpha2;
+    std::vector<uint16_t> rect_corner;
+    std::vector<unsigned char> corner_x;
+    std::vector<unsigned char> corner_y;
+};
+
+CascadeLayout::CascadeLayout()
+{
+    nstages = 0;
+    count = 0;
+    builtin = false;
+    stage_features = NULL;
+    stage_two_rect = NULL;
+    stage_thresh = NULL;
+    stage_limit = NULL;
+    rectangles = NULL;
+    weights = NULL;
+    tree_thresh = NULL;
+    alpha1 = NULL;
+    alpha2 = NULL;
+    stage_corners = NULL;
+    corner_x = NULL;
+    corner_y = NULL;
+    rect_corner = NULL;
+    image = NULL;
+    image_size = 0;
+    storage = NULL;
+    mapping = NULL;
+}
+
+CascadeLayout::~CascadeLayout()
+{
+    delete[] storage;
+    if( mapping != NULL )
+        munmap(mapping, image_size);
+}
+
+/**************************************************
+* runCascadeClassifier rejects a window at stage i
+* when stage_sum < 0.4*stage_thresh[i].
+* stage_limit[i] is the smallest integer passing
+* the test, so the SIMD, stage-major and compiled
+* engines compare integers.
+**************************************************/
+static int stageLimit(int stage_thresh)
+{
+    int limit = (fx_scale_t)0.4*stage_thresh;
+
+    if( limit < (fx_scale_t)0.4*stage_thresh )
+        limit++;
+    return limit;
+}
+
+/* the corners of each stage, every (x, y) once, and the rectangles as indices into them */
+static void buildCorners(LayoutTables* t)
+{
+    int i, j, k, c;
+    int corner_index[CASCADE_WINDOW_SIZE+1][CASCADE_WINDOW_SIZE+1]; // of (x, y) in the current stage, -1 when not listed yet
+    int f = 0, f_end = 0, ncorners = 0;
+    int nstages = t->stage_features.size();
+
+    t->stage_corners.resize(nstages + 1);
+    t->rect_corner.assign(t->rectangles.size(), 0);
+    for( i = 0; i < nstages; i++ )
+    {
+        t->stage_corners[i] = ncorners;
+        memset(corner_index, -1, sizeof(corner_index));
+        f_end += t->stage_features[i];
+        for( ; f < f_end; f++ )
+        {
+            for( k = 0; k < (CascadeLayout::hasThirdRect(&t->rectangles[12*f]) ? 3 : 2); k++ )
+            {
+                const int* r = &t->rectangles[12*f + 4*k];
+                /* same corner order as buildRectOffsets */
+                int cx[4] = { r[0], r[0] + r[2], r[0], r[0] + r[2] };
+                int cy[4] = { r[1], r[1], r[1] + r[3], r[1] + r[3] };
+
+                for( c = 0; c < 4; c++ )
+                {
+                    j = corner_index[cy[c]][cx[c]];
+                    if( j < 0 )
+                    {
+                        j = ncorners - t->stage_corners[i];
+                        corner_index[cy[c]][cx[c]] = j;
+                        t->corner_x.push_back(cx[c]);
+                        t->corner_y.push_back(cy[c]);
+                        ncorners++;
+                    }
+                    t->rect_corner[12*f + 4*k + c] = j;
+                }
+            }
+        }
+    }
+    t->stage_corners[nstages] = ncorners;
+}
+
+/* the features of the cascade in layout order */
+static void buildTables(const HaarCascade& cascade, LayoutTables* t)
+{
+    int i, j, k, first = 0;
+    int nstages = cascade.stages.size();
+
+    t->stage_features.resize(nstages);
+    t->stage_two_rect.resize(nstages);
+    t->stage_thresh = cascade.stage_thresh;
+    t->stage_limit.resize(nstages);
+    for( i = 0; i < nstages; i++ )
+    {
+        int n = (cascade.stages[i] < MAX_STAGE_FEATURES) ? cascade.stages[i] : MAX_STAGE_FEATURES;
+
+        t->stage_features[i] = n;
+        t->stage_two_rect[i] = 0;
+        for( k = 2; k <= 3; k++ )
+        {
+            for( j = first; j < first + n; j++ )
+            {
+                if( CascadeLayout::hasThirdRect(&cascade.rectangles[12*j]) != (k == 3) )
+                    continue;
+                t->rectangles.insert(t->rectangles.end(), &cascade.rectangles[12*j], &cascade.rectangles[12*j] + 12);
+                t->weights.insert(t->weights.end(), &cascade.weights[3*j], &cascade.weights[3*j] + 3);
+                t->tree_thresh.push_back(cascade.tree_thresh[j]);
+                t->alpha1.push_back(cascade.alpha1[j]);
+                t->alpha2.push_back(cascade.alpha2[j]);
+                if( k == 2 )
+                    t->stage_two_rect[i]++;
+            }
+        }
+        /* as haar_counter in the facedetect module, the table index only advances over the evaluated features */
+        first += n;
+        t->stage_limit[i] = stageLimit(t->stage_thresh[i]);
+    }
+    buildCorners(t);
+}
+
+/* bytes of a table of the image */
+static size_t tableBytes(int table, int nstages, int count, int ncorners)
+{
+    switch( table )
+    {
+    case TABLE_STAGE_FEATURES:
+    case TABLE_STAGE_TWO_RECT:
+    case TABLE_STAGE_THRESH:
+    case TABLE_STAGE_LIMIT:
+        return (size_t)nstages*sizeof(int32_t);
+    case TABLE_STAGE_CORNERS:
+        return (size_t)(nstages + 1)*sizeof(int32_t);
+    case TABLE_RECTANGLES:
+        return (size_t)12*count*sizeof(int32_t);
+    case TABLE_WEIGHTS:
+        return (size_t)3*count*sizeof(int32_t);
+    case TABLE_RECT_CORNER:
+        return (size_t)12*count*sizeof(uint16_t);
+    case TABLE_CORNER_X:
+    case TABLE_CORNER_Y:
+        return (size_t)ncorners;
+    default:
+        return (size_t)count*sizeof(int32_t);
+    }
+}
+
+static size_t alignTable(size_t offset)
+{
+    return (offset + CASCADE_FILE_ALIGN-1) & ~(size_t)(CASCADE_FILE_ALIGN-1);
+}
+
+/************************************************************
+ * Points the tables of layout into image, after checking
+ * everything the engines rely on: the header, that the
+ * tables are inside the image, the stage sizes, that the
+ * rectangles are inside the window and that the corner
+ * indices are inside their stage. Returns -1 with an
+ * error message naming 'name' when the image is not a
+ * usable cascade.
+ ***********************************************************/
+static int attachImage(CascadeLayout* layout, const unsigned char* image, size_t size, const char* name)
+{
+    const CascadeFileHeader* h = (const CascadeFileHeader*)image;
+    const void* tables[CASCADE_TABLES];
+    int i, t, f, k, c, total = 0;
+
+    if( size < sizeof(CascadeFileHeader) || memcmp(h->magic, CASCADE_FILE_MAGIC, 8) != 0 )
+    {
+        printf("ERROR: %s is not a cascade file\n", name);
+        return -1;
+    }
+    if( h->byte_order != 0x01020304 || h->version != CASCADE_FILE_VERSION || h->header_size != sizeof(CascadeFileHeader) )
+    {
+        printf("ERROR: %s is a cascade file of version %u or of another byte order, this build reads version %d\n", name, h->version, CASCADE_FILE_VERSION);
+        return -1;
+    }
+    if( h->file_size != size || h->window_size != CASCADE_WINDOW_SIZE || h->max_stage_features != MAX_STAGE_FEATURES ||
+        h->nstages < 1 || h->count < 1 || h->ncorners < 0 || h->count > (int)(size/12) || h->nstages > (int)(size/4) || h->ncorners > (int)size )
+    {
+        printf("ERROR: the header of cascade file %s is not consistent\n", name);
+        return -1;
+    }
+    for( t = 0; t < CASCADE_TABLES; t++ )
+    {
+        if( h->table_offset[t] % CASCADE_FILE_ALIGN != 0 || h->table_offset[t] < sizeof(CascadeFileHeader) ||
+            h->table_offset[t] > size || tableBytes(t, h->nstages, h->count, h->ncorners) > size - h->table_offset[t] )
+        {
+            printf("ERROR: table %d of cascade file %s is not inside the file\n", t, name);
+            return -1;
+        }
+        tables[t] = image + h->table_offset[t];
+    }
+
+    layout->nstages = h->nstages;
+    layout->count = h->count;
+    layout->stage_features = (const int*)tables[TABLE_STAGE_FEATURES];
+    layout->stage_two_rect = (const int*)tables[TABLE_STAGE_TWO_RECT];
+    layout->stage_thresh = (const int*)tables[TABLE_STAGE_THRESH];
+    layout->stage_limit = (const int*)tables[TABLE_STAGE_LIMIT];
+    layout->stage_corners = (const int*)tables[TABLE_STAGE_CORNERS];
+    layout->rectangles = (const int*)tables[TABLE_RECTANGLES];
+    layout->weights = (const int*)tables[TABLE_WEIGHTS];
+    layout->tree_thresh = (const int*)tables[TABLE_TREE_THRESH];
+    layout->alpha1 = (const int*)tables[TABLE_ALPHA1];
+    layout->alpha2 = (const int*)tables[TABLE_ALPHA2];
+    layout->rect_corner = (const uint16_t*)tables[TABLE_RECT_CORNER];
+    layout->corner_x = (const unsigned char*)tables[TABLE_CORNER_X];
+    layout->corner_y = (const unsigned char*)tables[TABLE_CORNER_Y];
+    layout->image = image;
+    layout->image_size = size;
+
+    if( layout->stage_corners[0] != 0 || layout->stage_corners[layout->nstages] != h->ncorners )
+    {
+        printf("ERROR: the corner table of cascade file %s is not consistent\n", name);
+        return -1;
+    }
+    for( i = 0; i < layout->nstages; i++ )
+    {
+        int ncorners = layout->stage_corners[i+1] - layout->stage_corners[i];
+
+        if( layout->stage_features[i] < 1 || layout->stage_features[i] > MAX_STAGE_FEATURES || layout->stage_features[i] > layout->count - total ||
+            layout->stage_two_rect[i] < 0 || layout->stage_two_rect[i] > layout->stage_features[i] ||
+            layout->stage_limit[i] != stageLimit(layout->stage_thresh[i]) ||
+            ncorners < 0 || ncorners > (CASCADE_WINDOW_SIZE+1)*(CASCADE_WINDOW_SIZE+1) )
+        {
+            printf("ERROR: stage %d of cascade file %s is not consistent\n", i, name);
+            return -1;
+        }
+        for( f = total; f < total + layout->stage_features[i]; f++ )
+        {
+            for( k = 0; k < 3; k++ )
+            {
+                const int* r = &layout->rectangles[12*f + 4*k];
+
+                if( k == 2 && !CascadeLayout::hasThirdRect(&layout->rectangles[12*f]) )
+                    break;
+                if( r[0] < 0 || r[1] < 0 || r[2] < 0 || r[3] < 0 ||
+                    r[0] + r[2] > CASCADE_WINDOW_SIZE || r[1] + r[3] > CASCADE_WINDOW_SIZE )
+                {
+                    printf("ERROR: feature %d of cascade file %s is not in the window\n", f, name);
+                    return -1;
+                }
+                for( c = 0; c < 4; c++ )
+                {
+                    if( layout->rect_corner[12*f + 4*k + c] >= ncorners )
+                    {
+                        printf("ERROR: feature %d of cascade file %s has a corner outside its stage\n", f, name);
+                        return -1;
+                    }
+                }
+            }
+            /* the kernel of a feature is chosen by its position in the stage */
+            if( CascadeLayout::hasThirdRect(&layout->rectangles[12*f]) != (f - total >= layout->stage_two_rect[i]) )
+            {
+                printf("ERROR: feature %d of cascade file %s is not in the order of the layout\n", f, name);
+                return -1;
+            }
+        }
+        total += layout->stage_features[i];
+    }
+    if( total != layout->count )
+    {
+        printf("ERROR: the stages of cascade file %s do not have its %d features\n", name, layout->count);
+        return -1;
+    }
+    for( c = 0; c < h->ncorners; c++ )
+    {
+        if( layout->corner_x[c] > CASCADE_WINDOW_SIZE || layout->corner_y[c] > CASCADE_WINDOW_SIZE )
+        {
+            printf("ERROR: corner %d of cascade file %s is not in the window\n", c, name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+CascadeLayout* buildCascadeLayout(const HaarCascade& cascade)
+{
+    LayoutTables t;
+    CascadeFileHeader h;
+    const void* data[CASCADE_TABLES];
+    CascadeLayout* layout = new CascadeLayout();
+    unsigned char* image;
+    size_t offset;
+    int k;
+
+    buildTables(cascade, &t);
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CASCADE_FILE_MAGIC, 8);
+    h.version = CASCADE_FILE_VERSION;
+    h.byte_order = 0x01020304;
+    h.header_size = sizeof(CascadeFileHeader);
+    h.window_size = CASCADE_WINDOW_SIZE;
+    h.max_stage_features = MAX_STAGE_FEATURES;
+    h.nstages = t.stage_features.size();
+    h.count = t.alpha1.size();
+    h.ncorners = t.corner_x.size();
+
+    data[TABLE_STAGE_FEATURES] = t.stage_features.data();
+    data[TABLE_STAGE_TWO_RECT] = t.stage_two_rect.data();
+    data[TABLE_STAGE_THRESH] = t.stage_thresh.data();
+    data[TABLE_STAGE_LIMIT] = t.stage_limit.data();
+    data[TABLE_STAGE_CORNERS] = t.stage_corners.data();
+    data[TABLE_RECTANGLES] = t.rectangles.data();
+    data[TABLE_WEIGHTS] = t.weights.data();
+    data[TABLE_TREE_THRESH] = t.tree_thresh.data();
+    data[TABLE_ALPHA1] = t.alpha1.data();
+    data[TABLE_ALPHA2] = t.alpha2.data();
+    data[TABLE_RECT_CORNER] = t.rect_corner.data();
+    data[TABLE_CORNER_X] = t.corner_x.data();
+    data[TABLE_CORNER_Y] = t.corner_y.data();
+
+    offset = sizeof(CascadeFileHeader);
+    for( k = 0; k < CASCADE_TABLES; k++ )
+    {
+        offset = alignTable(offset);
+        h.table_offset[k] = offset;
+        offset += tableBytes(k, h.nstages, h.count, h.ncorners);
+    }
+    h.file_size = alignTable(offset);
+
+    /* the image from a cache line, as a mapped file would be */
+    layout->storage = new unsigned char[h.file_size + CASCADE_FILE_ALIGN];
+    image = (unsigned char*)(((uintptr_t)layout->storage + CASCADE_FILE_ALIGN-1) & ~(uintptr_t)(CASCADE_FILE_ALIGN-1));
+    memset(image, 0, h.file_size);
+    memcpy(image, &h, sizeof(h));
+    for( k = 0; k < CASCADE_TABLES; k++ )
+        memcpy(image + h.table_offset[k], data[k], tableBytes(k, h.nstages, h.count, h.ncorners));
+
+    if( attachImage(layout, image, h.file_size, "(built)") < 0 )
+    {
+        delete layout;
+        return NULL;
+    }
+    return layout;
+}
+
+static CascadeLayout* makeBuiltinLayout(void)
+{
+    CascadeLayout* layout = buildCascadeLayout(builtinCascade());
+
+    layout->builtin = true;
+    return layout;
+}
+
+const CascadeLayout* builtinLayout(void)
+{
+    static const CascadeLayout* layout = makeBuiltinLayout();
+    return layout;
+}
+
+int writeCascadeFile(const char* file, const CascadeLayout* layout)
+{
+    FILE* fp = fopen(file, "wb");
+
+    if( fp == NULL )
+    {
+        printf("ERROR: cannot write %s\n", file);
+        return -1;
+    }
+    if( fwrite(layout->image, 1, layout->image_size, fp) != layout->image_size )
+    {
+        printf("ERROR: cannot write %s\n", file);
+        fclose(fp);
+        return -1;
+    }
+    if( fclose(fp) != 0 )
+    {
+        printf("ERROR: cannot write %s\n", file);
+        return -1;
+    }
+    return 0;
+}
+
+CascadeLayout* mapCascadeFile(const char* file)
+{
+    CascadeLayout* layout;
+    struct stat st;
+    void* mapping;
+    int fd;
+
+    fd = open(file, O_RDONLY);
+    if( fd < 0 )
+    {
+        printf("ERROR: cannot open %s\n", file);
+        return NULL;
+    }
+    if( fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CascadeFileHeader) )
+    {
+        printf("ERROR: %s is not a cascade file\n", file);
+        close(fd);
+        return NULL;
+    }
+    /* read-only and shared: the pages are those of the page cache, whichever process maps the file */
+    mapping = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if( mapping == MAP_FAILED )
+    {
+        printf("ERROR: cannot map %s\n", file);
+        return NULL;
+    }
+
+    layout = new CascadeLayout();
+    layout->mapping = mapping;
+    layout->image_size = st.st_size;
+    if( attachImage(layout, (const unsigned char*)mapping, st.st_size, file) < 0 )
+    {
+        delete layout;
+        return NULL;
+    }
+    return layout;
+}
@@ -0,0 +1,136 @@
+//============================================================================================
+//
+// File Name    : cascade_layout.h
+// Description  : Cascade tables in the order of the host engines, and their binary file
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Layout out of facedetect_host.cpp, mapped cascade files
+//============================================================================================
+
+#ifndef CASCADE_LAYOUT_H
+#define CASCADE_LAYOUT_H
+
+#include "haar_cascade.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define CASCADE_FILE_MAGIC "HAARCASC"
+#define CASCADE_FILE_VERSION 1
+/* every table of a cascade image starts on a cache line, for the vector loads of the SIMD engines */
+#define CASCADE_FILE_ALIGN 64
+/* features of a stage evaluated by runCascadeClassifier */
+#define MAX_STAGE_FEATURES 200
+
+/* tables of a cascade image, in file order */
+enum CascadeTable
+{
+    TABLE_STAGE_FEATURES = 0,  // int per stage
+    TABLE_STAGE_TWO_RECT,      // int per stage
+    TABLE_STAGE_THRESH,        // int per stage
+    TABLE_STAGE_LIMIT,         // int per stage
+    TABLE_STAGE_CORNERS,       // int per stage, and one more
+    TABLE_RECTANGLES,          // 12 ints per feature
+    TABLE_WEIGHTS,             // 3 ints per feature
+    TABLE_TREE_THRESH,         // int per feature
+    TABLE_ALPHA1,              // int per feature
+    TABLE_ALPHA2,              // int per feature
+    TABLE_RECT_CORNER,         // 12 uint16_t per feature
+    TABLE_CORNER_X,            // byte per corner
+    TABLE_CORNER_Y,            // byte per corner
+    CASCADE_TABLES
+};
+
+/****************************************************************
+ * Binary cascade file (.hcb), version 1: this header, then the
+ * tables of CascadeLayout one after the other, each at a
+ * multiple of CASCADE_FILE_ALIGN. All values are in the byte
+ * order of the machine that wrote the file, which byte_order
+ * tells. The file is used in place: mapCascadeFile maps it
+ * read-only and the engines read the tables from the mapping,
+ * so the processes using the same file share its pages.
+ ***************************************************************/
+struct CascadeFileHeader
+{
+    char magic[8];              // CASCADE_FILE_MAGIC, no terminating 0
+    uint32_t version;           // CASCADE_FILE_VERSION
+    uint32_t byte_order;        // 0x01020304
+    uint32_t header_size;       // sizeof(CascadeFileHeader)
+    uint32_t file_size;
+    int32_t window_size;        // CASCADE_WINDOW_SIZE
+    int32_t max_stage_features; // MAX_STAGE_FEATURES
+    int32_t nstages;
+    int32_t count;
+    int32_t ncorners;
+    int32_t reserved;
+    uint32_t table_offset[CASCADE_TABLES]; // from the start of the file
+};
+
+/*******************************************************
+ * The features of a cascade in the order the host
+ * engines evaluate them: stage by stage, the first 200
+ * features of each stage as in runCascadeClassifier
+ * (the ones after are never read), and within a stage
+ * the 2-rectangle features before the 3-rectangle ones.
+ * A stage sum is a sum of integers, so the order within
+ * the stage does not change it, and each kind runs
+ * through its own kernel without testing for the third
+ * rectangle.
+ *
+ * The tables point into one cascade image, laid out as
+ * a cascade file: built in memory from a HaarCascade,
+ * or mapped from a file.
+ ******************************************************/
+struct CascadeLayout
+{
+    int nstages;
+    int count;                      // features evaluated by the cascade
+    bool builtin;                   // builtinCascade, the one compiled by make host_compiled
+    const int* stage_features;      // features of each stage, at most 200
+    const int* stage_two_rect;      // the first stage_two_rect[i] of them have 2 rectangles
+    const int* stage_thresh;        // threshold of each stage
+    const int* stage_limit;         // integer form of the stage threshold test
+    const int* rectangles;          // the tables of the cascade in this order
+    const int* weights;
+    const int* tree_thresh;
+    const int* alpha1;
+    const int* alpha2;
+
+    /* the rectangle corners of each stage, every (x, y) once, and the features as indices into them */
+    const int* stage_corners;       // corners of stage i are stage_corners[i] to stage_corners[i+1]-1
+    const unsigned char* corner_x;
+    const unsigned char* corner_y;
+    const uint16_t* rect_corner;    // like the rectangle offsets, but the corner within the stage
+
+    const unsigned char* image;     // the cascade image the tables point into
+    size_t image_size;
+    unsigned char* storage;         // image built in memory, NULL when mapped
+    void* mapping;                  // image mapped from a file, NULL when built
+
+    CascadeLayout();
+    ~CascadeLayout();
+
+    /* r: the 3 rectangles of a feature */
+    static bool hasThirdRect(const int* r)
+    {
+        return r[8] != 0 || r[9] != 0 || r[10] != 0 || r[11] != 0;
+    }
+};
+
+/* layout of builtinCascade, built on first use and shared */
+const CascadeLayout* builtinLayout(void);
+
+/* layout of a cascade that has passed checkCascade */
+CascadeLayout* buildCascadeLayout(const HaarCascade& cascade);
+
+/* the image of a layout as a cascade file; returns 0, or -1 with an error message */
+int writeCascadeFile(const char* file, const CascadeLayout* layout);
+
+/* a cascade file mapped read-only, NULL with an error message when it cannot be used */
+CascadeLayout* mapCascadeFile(const char* file);
+
+#endif
@@ -0,0 +1,224 @@
+//============================================================================================
+//
+// File Name    : cascade_simd.cpp
+// Description  : SIMD cascade evaluation of adjacent detection windows (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  AVX2 / AVX-512 window-parallel cascade
+//17/10/2026  1.1       UTD DARClab                  2-rectangle and 3-rectangle feature kernels
+//17/10/2026  1.2       UTD DARClab                  Corners shared by the features of a stage
+//17/10/2026  1.3       UTD DARClab                  Variance normalization of a row of windows
+//17/10/2026  1.4       UTD DARClab                  Variance floor
+//============================================================================================
+
+/****************************************************************
+ * Adjacent windows of a row read the same feature at adjacent
+ * integral-image addresses, so one vector load fetches a corner
+ * for 8 (AVX2) or 16 (AVX-512) windows when shiftStep is 1, and
+ * one gather when it is larger. Each lane has an alive bit, and
+ * a stage is evaluated as long as one lane is alive.
+ *
+ * The kernel in cascade_simd.inc is compiled once per
+ * instruction set with '#pragma GCC target' and picked at
+ * run time, so the library does not need to be built with
+ * -mavx2. The 16-lane kernel is a separate engine: a block
+ * stays in the cascade until its last lane is rejected, so
+ * the wider blocks save instructions per window but do more
+ * stages, and on the 360x240 test images both widths run at
+ * about the same speed.
+ ***************************************************************/
+
+#include "cascade_simd.h"
+#include <stddef.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#include <immintrin.h>
+
+/*********************** AVX2: 8 windows ***********************/
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace cascade_avx2 {
+
+typedef __m256i vec;
+typedef __m256i mask;
+
+static const int LANES = 8;
+
+static inline vec load(const int* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline void store(int* p, vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+static inline vec gather(const int* p, vec index) { return _mm256_i32gather_epi32(p, index, 4); }
+static inline vec set1(int v) { return _mm256_set1_epi32(v); }
+static inline vec laneIndex(void) { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+static inline vec add(vec a, vec b) { return _mm256_add_epi32(a, b); }
+static inline vec sub(vec a, vec b) { return _mm256_sub_epi32(a, b); }
+static inline vec mullo(vec a, vec b) { return _mm256_mullo_epi32(a, b); }
+static inline mask lessThan(vec a, vec b) { return _mm256_cmpgt_epi32(b, a); }
+static inline vec select(mask m, vec if_set, vec if_clear) { return _mm256_blendv_epi8(if_clear, if_set, m); }
+static inline mask andNot(mask m, mask a) { return _mm256_andnot_si256(m, a); }
+static inline mask allLanes(void) { return _mm256_set1_epi32(-1); }
+static inline int maskBits(mask m) { return _mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+static inline mask isZero(vec v) { return _mm256_cmpeq_epi32(v, _mm256_setzero_si256()); }
+
+/* int_sqrt of an unsigned 32-bit value, 1 when the value is 0 */
+static inline vec sqrtOrOne(vec v)
+{
+    /* unsigned to double: flip the sign bit, convert as signed and add 2^31 back */
+    __m256i biased = _mm256_xor_si256(v, _mm256_set1_epi32(0x80000000));
+    __m256d lo = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(biased)), _mm256_set1_pd(2147483648.0));
+    __m256d hi = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(biased, 1)), _mm256_set1_pd(2147483648.0));
+    /* the square root is correctly rounded, so truncating it gives floor(sqrt(v)) exactly for 32-bit v */
+    vec root = _mm256_set_m128i(_mm256_cvttpd_epi32(_mm256_sqrt_pd(hi)), _mm256_cvttpd_epi32(_mm256_sqrt_pd(lo)));
+    return select(_mm256_cmpeq_epi32(v, _mm256_setzero_si256()), set1(1), root);
+}
+
+/* lanes where area*sqsum - sum*sum < limit, in double precision, exact for the sums of a 24 x 24 window */
+static inline mask lowVariance(vec sum, vec sqsum, int area, double limit)
+{
+    __m256d a = _mm256_set1_pd((double)area);
+    __m256d s_lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(sum));
+    __m256d s_hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(sum, 1));
+    __m256d v_lo = _mm256_sub_pd(_mm256_mul_pd(a, _mm256_cvtepi32_pd(_mm256_castsi256_si128(sqsum))), _mm256_mul_pd(s_lo, s_lo));
+    __m256d v_hi = _mm256_sub_pd(_mm256_mul_pd(a, _mm256_cvtepi32_pd(_mm256_extracti128_si256(sqsum, 1))), _mm256_mul_pd(s_hi, s_hi));
+    /* the 64-bit compare results, their even 32-bit halves in the lane order */
+    __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    __m256i lo = _mm256_permutevar8x32_epi32(_mm256_castpd_si256(_mm256_cmp_pd(v_lo, _mm256_set1_pd(limit), _CMP_LT_OQ)), even);
+    __m256i hi = _mm256_permutevar8x32_epi32(_mm256_castpd_si256(_mm256_cmp_pd(v_hi, _mm256_set1_pd(limit), _CMP_LT_OQ)), even);
+    return _mm256_set_m128i(_mm256_castsi256_si128(hi), _mm256_castsi256_si128(lo));
+}
+
+#include "cascade_simd.inc"
+
+} // namespace cascade_avx2
+
+#pragma GCC pop_options
+
+/********************* AVX-512: 16 windows *********************/
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+
+namespace cascade_avx512 {
+
+typedef __m512i vec;
+typedef __mmask16 mask;
+
+static const int LANES = 16;
+
+static inline vec load(const int* p) { return _mm512_loadu_si512((const void*)p); }
+static inline void store(int* p, vec v) { _mm512_storeu_si512((void*)p, v); }
+static inline vec gather(const int* p, vec index) { return _mm512_i32gather_epi32(index, (const void*)p, 4); }
+static inline vec set1(int v) { return _mm512_set1_epi32(v); }
+static inline vec laneIndex(void) { return _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+static inline vec add(vec a, vec b) { return _mm512_add_epi32(a, b); }
+static inline vec sub(vec a, vec b) { return _mm512_sub_epi32(a, b); }
+static inline vec mullo(vec a, vec b) { return _mm512_mullo_epi32(a, b); }
+static inline mask lessThan(vec a, vec b) { return _mm512_cmplt_epi32_mask(a, b); }
+static inline vec select(mask m, vec if_set, vec if_clear) { return _mm512_mask_blend_epi32(m, if_clear, if_set); }
+static inline mask andNot(mask m, mask a) { return (mask)(~m & a); }
+static inline mask allLanes(void) { return (mask)0xFFFF; }
+static inline int maskBits(mask m) { return (int)m; }
+static inline mask isZero(vec v) { return _mm512_cmpeq_epi32_mask(v, _mm512_setzero_si512()); }
+
+/* int_sqrt of an unsigned 32-bit value, 1 when the value is 0 */
+static inline vec sqrtOrOne(vec v)
+{
+    __m512d lo = _mm512_cvtepu32_pd(_mm512_castsi512_si256(v));
+    __m512d hi = _mm512_cvtepu32_pd(_mm512_extracti64x4_epi64(v, 1));
+    /* the square root is correctly rounded, so truncating it gives floor(sqrt(v)) exactly for 32-bit v */
+    vec root = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvttpd_epu32(_mm512_sqrt_pd(lo))),
+                                  _mm512_cvttpd_epu32(_mm512_sqrt_pd(hi)), 1);
+    return select(_mm512_cmpeq_epi32_mask(v, _mm512_setzero_si512()), set1(1), root);
+}
+
+/* lanes where area*sqsum - sum*sum < limit, in double precision, exact for the sums of a 24 x 24 window */
+static inline mask lowVariance(vec sum, vec sqsum, int area, double limit)
+{
+    __m512d a = _mm512_set1_pd((double)area);
+    __m512d s_lo = _mm512_cvtepi32_pd(_mm512_castsi512_si256(sum));
+    __m512d s_hi = _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(sum, 1));
+    __m512d v_lo = _mm512_sub_pd(_mm512_mul_pd(a, _mm512_cvtepi32_pd(_mm512_castsi512_si256(sqsum))), _mm512_mul_pd(s_lo, s_lo));
+    __m512d v_hi = _mm512_sub_pd(_mm512_mul_pd(a, _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(sqsum, 1))), _mm512_mul_pd(s_hi, s_hi));
+    return (mask)(_mm512_cmp_pd_mask(v_lo, _mm512_set1_pd(limit), _CMP_LT_OQ)
+                | (_mm512_cmp_pd_mask(v_hi, _mm512_set1_pd(limit), _CMP_LT_OQ) << 8));
+}
+
+#include "cascade_simd.inc"
+
+} // namespace cascade_avx512
+
+#pragma GCC pop_options
+
+/* instruction sets of this CPU, looked up once */
+static int simdSupport(void)
+{
+    static const int support = (__builtin_cpu_init(), 0)
+                             | (__builtin_cpu_supports("avx2") ? 8 : 0)
+                             | (__builtin_cpu_supports("avx512f") ? 16 : 0);
+    return support;
+}
+
+int cascadeSimdLanes(int wide)
+{
+    int support = simdSupport();
+
+    if( wide && (support & 16) )
+        return cascade_avx512::LANES;
+    if( support & 8 )
+        return cascade_avx2::LANES;
+    return 0;
+}
+
+int runCascadeSimd(const CascadeView* view, int lanes, int x, int step, const int* norm)
+{
+    if( lanes == cascade_avx512::LANES )
+        return cascade_avx512::runCascadeLanes(view, x, step, norm);
+    else
+        return cascade_avx2::runCascadeLanes(view, x, step, norm);
+}
+
+int runStageSimd(const CascadeView* view, int lanes, int stage, int first_feature, const int* win_x, const int* norm, int* stage_sum, int n)
+{
+    if( lanes == cascade_avx512::LANES )
+        return cascade_avx512::runStageList(view, stage, first_feature, win_x, norm, stage_sum, n);
+    else
+        return cascade_avx2::runStageList(view, stage, first_feature, win_x, norm, stage_sum, n);
+}
+
+int varianceNormSimd(const CascadeView* view, int lanes, int x, int step, int n, int* norm)
+{
+    if( lanes == cascade_avx512::LANES )
+        return cascade_avx512::varianceNormList(view, x, step, n, norm);
+    else
+        return cascade_avx2::varianceNormList(view, x, step, n, norm);
+}
+
+#else
+
+/* no SIMD kernel for this target, the scalar engine is used */
+int cascadeSimdLanes(int wide)
+{
+    return 0;
+}
+
+int runCascadeSimd(const CascadeView* view, int lanes, int x, int step, const int* norm)
+{
+    return 0;
+}
+
+int runStageSimd(const CascadeView* view, int lanes, int stage, int first_feature, const int* win_x, const int* norm, int* stage_sum, int n)
+{
+    return 0;
+}
+
+int varianceNormSimd(const CascadeView* view, int lanes, int x, int step, int n, int* norm)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,115 @@
+//============================================================================================
+//
+// File Name    : cascade_simd.h
+// Description  : SIMD cascade evaluation of adjacent detection windows (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  AVX2 / AVX-512 window-parallel cascade
+//17/10/2026  1.1       UTD DARClab                  16-bit rectangle offsets
+//17/10/2026  1.2       UTD DARClab                  Packed weak-classifier records
+//17/10/2026  1.3       UTD DARClab                  Corners shared by the features of a stage
+//17/10/2026  1.4       UTD DARClab                  Variance normalization of a row of windows
+//17/10/2026  1.5       UTD DARClab                  Variance floor
+//============================================================================================
+
+#ifndef CASCADE_SIMD_H
+#define CASCADE_SIMD_H
+
+#include <stdint.h>
+
+/* offset of a rectangle corner in the integral image window, RECT_OFFSET_NULL marks a missing 3rd rectangle */
+typedef uint16_t rect_offset_t;
+#define RECT_OFFSET_NULL 0xFFFF
+
+/* corners the gather kernels keep for one stage, a stage with more reads each feature directly */
+#define MAX_STAGE_CORNERS 640
+
+#ifdef PACKED_CLASSIFIERS
+/**********************************************************
+ * make host PACKED=1: everything a weak classifier reads
+ * besides the integral image, in one cache line, in
+ * feature order, so the features of the first stages,
+ * which nearly every window evaluates, are contiguous
+ *********************************************************/
+struct alignas(64) WeakClassifier
+{
+    rect_offset_t offsets[12];  // scaled_rectangles_array of the feature
+    int weights[3];             // weights_array
+    int tree_thresh;            // tree_thresh_array
+    int alpha1;                 // alpha1_array
+    int alpha2;                 // alpha2_array
+};
+#endif
+
+/* everything the SIMD kernel reads, for one scale and one y_bias */
+struct CascadeView
+{
+    const int* sum;                 // integral image buffer, 25 rows of width
+    const int* sqsum;               // squared integral image buffer
+    const rect_offset_t* rect_offsets; // scaled_rectangles_array, 12 offsets per feature
+    const int* weights;             // the feature tables, in the order of rect_offsets
+    const int* tree_thresh;
+    const int* alpha1;
+    const int* alpha2;
+    const int* stages;              // features evaluated per stage (at most 200)
+    const int* two_rect;            // the first two_rect[i] features of stage i have 2 rectangles, the others 3
+    const rect_offset_t* corner_offsets; // the distinct rectangle corners of each stage
+    const int* stage_corners;       // corners of stage i are stage_corners[i] to stage_corners[i+1]-1
+    const uint16_t* rect_corners;   // 12 per feature, like rect_offsets but the corner within the stage
+    const int* stage_limit;         // windows with stage_sum < stage_limit[i] are rejected at stage i
+    int nstages;
+    int width;                      // row stride of sum and sqsum
+    int win_width;                  // detection window size (24 x 24)
+    int win_height;
+    int inv_window_area;
+    int var_floor;                  // windows with a lower grey-level variance are rejected before stage 0, 0: none
+#ifdef PACKED_CLASSIFIERS
+    const WeakClassifier* classifiers; // used instead of rect_offsets, weights, tree_thresh, alpha1 and alpha2
+#endif
+};
+
+/**********************************************************
+ * number of windows evaluated at once: 16 (AVX-512) when
+ * 'wide' is set and the CPU supports it, otherwise 8
+ * (AVX2), or 0 when the CPU has neither
+ *********************************************************/
+int cascadeSimdLanes(int wide);
+
+/**********************************************************
+ * run the cascade on 'lanes' windows at
+ * x, x+step, x+2*step, ... of the first row of the view,
+ * with variance_norm_factor norm[k] (varianceNormSimd),
+ * a window with norm[k] == 0 being rejected at once.
+ * Returns a bit mask of the windows that passed all
+ * stages (bit k for the window at x+k*step), with the
+ * same result as runCascadeClassifier for each window.
+ *********************************************************/
+int runCascadeSimd(const CascadeView* view, int lanes, int x, int step, const int* norm);
+
+/**********************************************************
+ * stage-major engine: the sum of the features of 'stage',
+ * the first of them being first_feature, for the windows
+ * at win_x[k] (first row of the view), with
+ * variance_norm_factor norm[k], into stage_sum[k]. Whole
+ * blocks of 'lanes' windows are done; returns how many
+ * windows that covers.
+ *********************************************************/
+int runStageSimd(const CascadeView* view, int lanes, int stage, int first_feature, const int* win_x, const int* norm, int* stage_sum, int n);
+
+/**********************************************************
+ * variance_norm_factor of the n windows at x, x+step, ...
+ * of the first row of the view into norm[k], the same
+ * values as varianceNormFactor: the square root is taken
+ * in double precision, which truncates to int_sqrt for
+ * every 32-bit value. A window with a grey-level variance
+ * below view->var_floor gets 0. Whole blocks of 'lanes'
+ * windows are done; returns how many windows that covers.
+ *********************************************************/
+int varianceNormSimd(const CascadeView* view, int lanes, int x, int step, int n, int* norm);
+
+#endif
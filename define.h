@@ -10,14 +10,64 @@
 // Date       Version   Author                       Description
 //--------------------------------------------------------------------------------------------
 //25/03/2019  1.0       UTD DARClab	                 face detector main definition header 
+//17/10/2026  1.1       UTD DARClab                  fixed-point typedefs, native types for the host build
+//17/10/2026  1.2       UTD DARClab                  wide types for host frames of any size
+//18/10/2026  1.3       UTD DARClab                  wide reciprocal for classes of MAX_NUM_FACE candidates or more
 //============================================================================================
 
 #ifndef DEFINE_H
 #define DEFINE_H
 
+/*******************************************************
+ * Fixed-point types of the detector.
+ * By default they are the SystemC types. The host build
+ * defines NATIVE_FIXED to use the bit-exact integer
+ * implementation in fixed_point.h instead, and does not
+ * need SystemC at all.
+ *
+ * The fx_wide types have the same fraction bits as the
+ * types of the facedetect module and more integer bits,
+ * for the larger frames the host build takes. They give
+ * the same values as long as the module's types do not
+ * saturate, which they never do on 360x240 frames.
+ * fx_wide_recip_t is the exception: it has more fraction
+ * bits, for the classes of MAX_NUM_FACE candidates or
+ * more that only the host build groups.
+ ******************************************************/
+#ifdef NATIVE_FIXED
+
+#include "fixed_point.h"
+
+typedef fx_ufixed<8,1>   fx_scale_t;  // scale factor and grouping eps
+typedef fx_ufixed<10,5>  fx_factor_t; // accumulated pyramid scaling factor
+typedef fx_ufixed<16,12> fx_round_t;  // argument of myRound
+typedef fx_ufixed<16,8>  fx_delta_t;  // rectangle similarity threshold in predicate
+typedef fx_ufixed<10,1>  fx_recip_t;  // 1/weight in groupRectangles
+
+typedef fx_ufixed<14,9>  fx_wide_factor_t; // fx_factor_t of the host build, frames up to 12288 pixels high
+typedef fx_ufixed<20,16> fx_wide_round_t;  // fx_round_t of the host build, coordinates up to 65535
+typedef fx_ufixed<20,12> fx_wide_delta_t;  // fx_delta_t of the host build, faces up to 10000 pixels
+typedef fx_ufixed<24,1>  fx_wide_recip_t;  // 1/weight of the classes of MAX_NUM_FACE candidates or more
+
+#else
+
 #define SC_INCLUDE_FX
 
 #include "systemc.h"
+
+typedef sc_ufixed<8,1,SC_RND,SC_SAT>   fx_scale_t;
+typedef sc_ufixed<10,5,SC_RND,SC_SAT>  fx_factor_t;
+typedef sc_ufixed<16,12,SC_RND,SC_SAT> fx_round_t;
+typedef sc_ufixed<16,8,SC_RND,SC_SAT>  fx_delta_t;
+typedef sc_ufixed<10,1,SC_RND,SC_SAT>  fx_recip_t;
+
+typedef sc_ufixed<14,9,SC_RND,SC_SAT>  fx_wide_factor_t;
+typedef sc_ufixed<20,16,SC_RND,SC_SAT> fx_wide_round_t;
+typedef sc_ufixed<20,12,SC_RND,SC_SAT> fx_wide_delta_t;
+typedef sc_ufixed<24,1,SC_RND,SC_SAT>  fx_wide_recip_t;
+
+#endif
+
 #include <vector>
 #include <stdio.h>
 #include <stdlib.h>
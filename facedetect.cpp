@@ -12,6 +12,8 @@
 //--------------------------------------------------------------------------------------------
 //12/11/2012  1.0   Francesco Comaschi, TU Eindhoven    C++ implementation of Viola-Jones algorithm
 //25/03/2019  1.1   UTD DARClab	                        Convert it to synthesizable SystemC     
+//17/10/2026  1.2   UTD DARClab                         Fixed-point types through the define.h typedefs
+//17/10/2026  1.3   UTD DARClab                         Down-sampling fused into the integral image
 //============================================================================================
 
 #include "define.h"
@@ -94,9 +96,9 @@ const int stages_thresh_array[25] = {
 };
 
 /* rounding function */
-inline  int  myRound( sc_ufixed<16,12,SC_RND,SC_SAT> value )
+inline  int  myRound( fx_round_t value )
 {
-  return (int)(value + (sc_ufixed<16,12,SC_RND,SC_SAT>)0.5);
+  return (int)(value + (fx_round_t)0.5);
 }
 
 /*******************************************************
@@ -104,15 +106,15 @@ inline  int  myRound( sc_ufixed<16,12,SC_RND,SC_SAT> value )
  * Description: It calls all the major steps
  ******************************************************/
 
-void facedetect::detectObjects( MySize minSize, sc_ufixed<8,1,SC_RND,SC_SAT> scaleFactor, int minNeighbors, int shift_step)
+void facedetect::detectObjects( MySize minSize, fx_scale_t scaleFactor, int minNeighbors, int shift_step)
 {
 
     /* group overlaping windows */
-    const sc_ufixed<8,1,SC_RND,SC_SAT> GROUP_EPS = 0.4;
+    const fx_scale_t GROUP_EPS = 0.4;
     int y_bias, iter_counter = 0;
 
     /* scaling factor */
-    sc_ufixed<10,5,SC_RND,SC_SAT> factor;
+    fx_factor_t factor;
 
     /* window size of the training set */
     MySize winSize0 = cascadeObj.orig_window_size;
@@ -139,18 +141,19 @@ void facedetect::detectObjects( MySize minSize, sc_ufixed<8,1,SC_RND,SC_SAT> sca
             continue;
 
         /***************************************
-        * Compute-intensive step:
-        * building image pyramid by downsampling
-        * downsampling using nearest neighbor
+        * Image pyramid by nearest neighbor
+        * down-sampling: the pixel of each row
+        * and column of the scale, read by
+        * integralImages from in_img_buffer
         **************************************/
-        nearestNeighbor( downsample_buffer, sz.width, sz.height);
+        nearestNeighbor( sz.width, sz.height);
 
         /***************************************************
         * Compute-intensive step:
         * At each scale of the image pyramid,
         * compute a new integral and squared integral image
         ***************************************************/
-        integralImages(downsample_buffer, int_img_buffer, sq_int_buffer, sz.width, 25);
+        integralImages(int_img_buffer, sq_int_buffer, sz.width, 25);
 
         /**************************************************
         * Note:
@@ -166,7 +169,7 @@ void facedetect::detectObjects( MySize minSize, sc_ufixed<8,1,SC_RND,SC_SAT> sca
         for(y_bias=0; y_bias < sz.height-25+1; y_bias++){
             if(y_bias!=0)
                 // shift integral image buffer and only update the last row of pixels
-                integralmages_lastrow(downsample_buffer, int_img_buffer, sq_int_buffer, sz.width, y_bias);
+                integralmages_lastrow(int_img_buffer, sq_int_buffer, sz.width, y_bias);
             
             /****************************************************
             * Process the current scale with the cascaded fitler.
@@ -399,7 +402,7 @@ int facedetect::runCascadeClassifier( MyPoint pt, int start_stage, int width)
         **************************************************************/
 
         /* the number "0.4" is empirically chosen for 5kk73 */
-        if( stage_sum < (sc_ufixed<8,1,SC_RND,SC_SAT>)0.4*stages_thresh_array[i] ){
+        if( stage_sum < (fx_scale_t)0.4*stages_thresh_array[i] ){
             return -i;
         } /* end of the per-stage thresholding */
     } /* end of i loop */
@@ -407,7 +410,7 @@ int facedetect::runCascadeClassifier( MyPoint pt, int start_stage, int width)
 }
 
 
-void facedetect::ScaleImage_Invoker( sc_ufixed<10,5,SC_RND,SC_SAT> factor, int sum_col, int shift_step, int y_bias)
+void facedetect::ScaleImage_Invoker( fx_factor_t factor, int sum_col, int shift_step, int y_bias)
 {
 
     MyPoint p;
@@ -454,7 +457,7 @@ void facedetect::ScaleImage_Invoker( sc_ufixed<10,5,SC_RND,SC_SAT> factor, int s
  * More info:
  * http://en.wikipedia.org/wiki/Summed_area_table
  ****************************************************/
-void facedetect::integralImages( sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH], int *sumData, int *sqsumData, int width, int height)
+void facedetect::integralImages( int *sumData, int *sqsumData, int width, int height)
 {
     int x, y, s, sq, t, tq;
     unsigned char it;
@@ -466,7 +469,7 @@ void facedetect::integralImages( sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH], int
         /* loop over the number of columns */
         for( x = 0; x < width; x ++)
         {
-            it = src[y][x];
+            it = in_img_buffer[y_index[y]][x_index[x]];
             /* sum of the current row (integer)*/
             s += it;
             sq += it*it;
@@ -485,7 +488,7 @@ void facedetect::integralImages( sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH], int
 }
 
 // shift the buffer and only update the last row
-void facedetect::integralmages_lastrow(sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH], int *sumData, int *sqsumData, int width, int y_bias)
+void facedetect::integralmages_lastrow( int *sumData, int *sqsumData, int width, int y_bias)
 {
     int x, y, s, sq, t, tq;
     unsigned char it;
@@ -502,7 +505,7 @@ void facedetect::integralmages_lastrow(sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH]
     s = 0;
     sq = 0;
     for(x=0; x<width; x++){
-        it = src[24+y_bias][x];
+        it = in_img_buffer[y_index[24+y_bias]][x_index[x]];
         s += it;
         sq += it*it;
         
@@ -518,14 +521,15 @@ void facedetect::integralmages_lastrow(sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH]
 
 /***********************************************************
  * This function downsample an image using nearest neighbor
- * It is used to build the image pyramid
+ * It is used to build the image pyramid: pixel (j, i) of
+ * the scale is in_img_buffer[y_index[i]][x_index[j]], read
+ * by the integral image functions, so no down-sampled
+ * copy of the image is stored
  **********************************************************/
-void facedetect::nearestNeighbor ( sc_uint<8> dst[IMAGE_HEIGHT][IMAGE_WIDTH], int width, int height)
+void facedetect::nearestNeighbor ( int width, int height)
 {
 
-    int y;
     int j;
-    int x;
     int i;
     int w1 = IMAGE_WIDTH;
     int h1 = IMAGE_HEIGHT;
@@ -536,20 +540,16 @@ void facedetect::nearestNeighbor ( sc_uint<8> dst[IMAGE_HEIGHT][IMAGE_WIDTH], in
     int x_ratio = (int)((w1<<16)/w2) +1;
     int y_ratio = (int)((h1<<16)/h2) +1;
 
-    for (i=0;i<h2;i++)
+    for(j=0;j<w2;j++)
     {
-        y = ((i*y_ratio)>>16);
-        rat = 0;
-        for(j=0;j<w2;j++)
-        {
-            x = (rat>>16);
-            dst[i][j] = in_img_buffer[y][x];
-            rat += x_ratio;
-        }
+        x_index[j] = (rat>>16);
+        rat += x_ratio;
     }
+    for (i=0;i<h2;i++)
+        y_index[i] = ((i*y_ratio)>>16);
 }
 
-void facedetect::groupRectangles( int groupThreshold, sc_ufixed<8,1,SC_RND,SC_SAT> eps)
+void facedetect::groupRectangles( int groupThreshold, fx_scale_t eps)
 {
     if( groupThreshold <= 0 || face_number==0 )
         return;
@@ -585,7 +585,7 @@ void facedetect::groupRectangles( int groupThreshold, sc_ufixed<8,1,SC_RND,SC_SA
     for( i = 0; i < nclasses; i++ )
     {
         MyRect r = rrects[i];
-        sc_ufixed<10,1,SC_RND,SC_SAT> s = 1.0/rweights[i];
+        fx_recip_t s = 1.0/rweights[i];
         rrects[i].x = myRound(r.x*s);
         rrects[i].y = myRound(r.y*s);
         rrects[i].width = myRound(r.width*s);
@@ -638,7 +638,7 @@ void facedetect::groupRectangles( int groupThreshold, sc_ufixed<8,1,SC_RND,SC_SA
     }
 }
 
-int facedetect::partition(int* labels, sc_ufixed<8,1,SC_RND,SC_SAT> eps)
+int facedetect::partition(int* labels, fx_scale_t eps)
 {
     int i, j;
     int N = face_number;
@@ -730,9 +730,9 @@ int myAbs(int n)
     return -n;
 }
 
-int facedetect::predicate(sc_ufixed<8,1,SC_RND,SC_SAT> eps, sc_uint<OUT_BW> r1[4], sc_uint<OUT_BW> r2[4])
+int facedetect::predicate(fx_scale_t eps, sc_uint<OUT_BW> r1[4], sc_uint<OUT_BW> r2[4])
 {
-    sc_ufixed<16,8,SC_RND,SC_SAT> delta = (sc_ufixed<16,8,SC_RND,SC_SAT>)0.5*eps*(((r1[2]>r2[2]) ? r2[2] : r1[2]) + ((r1[3]>r2[3]) ? r2[3] : r1[3]));
+    fx_delta_t delta = (fx_delta_t)0.5*eps*(((r1[2]>r2[2]) ? r2[2] : r1[2]) + ((r1[3]>r2[3]) ? r2[3] : r1[3]));
     return myAbs(r1[0] - r2[0]) <= delta &&
         myAbs(r1[1] - r2[1]) <= delta &&
         myAbs(r1[0] + r1[2] - r2[0] - r2[2]) <= delta &&
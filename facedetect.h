@@ -12,6 +12,8 @@
 //--------------------------------------------------------------------------------------------
 //12/11/2012  1.0   Francesco Comaschi, TU Eindhoven    C++ implementation of Viola-Jones algorithm
 //25/03/2019  1.1   UTD DARClab	                        Convert it to synthesizable SystemC     
+//17/10/2026  1.2   UTD DARClab                         Fixed-point types through the define.h typedefs
+//17/10/2026  1.3   UTD DARClab                         Down-sampling fused into the integral image
 //============================================================================================
 
 #ifndef __HAAR_H__
@@ -26,13 +28,13 @@ SC_MODULE (facedetect){
     sc_in<bool> write_signal/* Cyber valid_sig_gen=write_signal_v */; 
     sc_in<bool> read_signal/* Cyber valid_sig_gen=read_signal_v */; // burst read valid signal
     sc_in<sc_uint<32> > in_data/* Cyber valid_sig_gen=in_data_v */; //4 8-bit pixels at a time
-    sc_in<sc_ufixed<8,1,SC_RND,SC_SAT> > scaleFactor_in/* Cyber valid_sig_gen=scaleFactor_in_v */; // scale factor for image down-sampling
+    sc_in<fx_scale_t > scaleFactor_in/* Cyber valid_sig_gen=scaleFactor_in_v */; // scale factor for image down-sampling
     sc_in<sc_uint<8> > shiftStep_in/* Cyber valid_sig_gen=shiftStep_in_v */; // pixel step for window shifting
     sc_out<sc_uint<OUT_BW*4> > out_data/* Cyber valid_sig_gen=out_data_v */; //{x,y,w,h} coordinate, bitwidth need to be changed for larger image size
     sc_out<sc_uint<8> > face_num_out/* Cyber valid_sig_gen=face_num_out_v */;
     sc_out<bool> ready/* Cyber valid_sig_gen=ready_v */;
     
-    sc_ufixed<8,1,SC_RND,SC_SAT> scaleFactor; 
+    fx_scale_t scaleFactor; 
     sc_uint<8> shiftStep;
     int minNeighbours;
     MySize minSize; 
@@ -40,7 +42,8 @@ SC_MODULE (facedetect){
     myCascade cascadeObj;
     
     sc_uint<8> in_img_buffer[IMAGE_HEIGHT][IMAGE_WIDTH];
-    sc_uint<8> downsample_buffer[IMAGE_HEIGHT][IMAGE_WIDTH];
+    sc_uint<OUT_BW> x_index[IMAGE_WIDTH]; // column of in_img_buffer of each column of the current scale
+    sc_uint<OUT_BW> y_index[IMAGE_HEIGHT]; // row of in_img_buffer of each row of the current scale
     int int_img_buffer[25 * IMAGE_WIDTH]; //integral image buffer
     int sq_int_buffer[25 * IMAGE_WIDTH]; // squared integral image buffer
     sc_uint<8> face_number;
@@ -60,23 +63,23 @@ SC_MODULE (facedetect){
     /* runs the cascade on the specified window */
     int runCascadeClassifier( MyPoint pt, int start_stage, int width);
 
-    void groupRectangles( int groupThreshold, sc_ufixed<8,1,SC_RND,SC_SAT> eps);
+    void groupRectangles( int groupThreshold, fx_scale_t eps);
 
-    int partition(int* labels, sc_ufixed<8,1,SC_RND,SC_SAT> eps);
+    int partition(int* labels, fx_scale_t eps);
     
-    int predicate(sc_ufixed<8,1,SC_RND,SC_SAT> eps, sc_uint<OUT_BW> r1[4], sc_uint<OUT_BW> r2[4]);
+    int predicate(fx_scale_t eps, sc_uint<OUT_BW> r1[4], sc_uint<OUT_BW> r2[4]);
     
-    void ScaleImage_Invoker( sc_ufixed<10,5,SC_RND,SC_SAT> factor, int sum_col, int shift_step, int y_bias);
+    void ScaleImage_Invoker( fx_factor_t factor, int sum_col, int shift_step, int y_bias);
     
     int evalWeakClassifier(int variance_norm_factor, int p_offset, int tree_index, int w_index, int r_index );
     
-    void integralImages( sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH], int *sumData, int *sqsumData, int width, int height);
+    void integralImages( int *sumData, int *sqsumData, int width, int height);
     
-    void integralmages_lastrow(sc_uint<8> src[IMAGE_HEIGHT][IMAGE_WIDTH], int *sumData, int *sqsumData, int width, int y_bias);
+    void integralmages_lastrow( int *sumData, int *sqsumData, int width, int y_bias);
     
-    void nearestNeighbor ( sc_uint<8> dst[IMAGE_HEIGHT][IMAGE_WIDTH], int width, int height);
+    void nearestNeighbor ( int width, int height);
 
-    void detectObjects(MySize minSize, sc_ufixed<8,1,SC_RND,SC_SAT> scale_factor, int min_neighbors, int shift_step);
+    void detectObjects(MySize minSize, fx_scale_t scale_factor, int min_neighbors, int shift_step);
 
     void detection_main();
             
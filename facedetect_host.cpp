@@ -0,0 +1,2527 @@
+//============================================================================================
+//
+// File Name    : facedetect_host.cpp
+// Description  : Host (software) build of the Viola-Jones face detector core
+// Release Date : 17/10/2026
+// Author       : Francesco Comaschi,
+//                Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                            Description
+//--------------------------------------------------------------------------------------------
+//12/11/2012  1.0       Francesco Comaschi, TU Eindhoven  C++ implementation of Viola-Jones algorithm
+//17/10/2026  1.1       UTD DARClab                       facedetect module pipeline as a plain C++ library
+//17/10/2026  1.2       UTD DARClab                       Pyramid levels on parallel workers
+//17/10/2026  1.3       UTD DARClab                       Row bands within a level
+//17/10/2026  1.4       UTD DARClab                       Work-stealing scheduler for the bands
+//17/10/2026  1.5       UTD DARClab                       Temporal-coherence mode for video
+//17/10/2026  1.6       UTD DARClab                       Frames of any size up to MAX_FRAME_SIZE
+//17/10/2026  1.7       UTD DARClab                       Ring buffer for the integral image window
+//17/10/2026  1.8       UTD DARClab                       Cache of the rectangle offsets per window width
+//17/10/2026  1.9       UTD DARClab                       Packed weak-classifier records, window counts
+//17/10/2026  1.10      UTD DARClab                       2-rectangle and 3-rectangle feature kernels
+//17/10/2026  1.11      UTD DARClab                       Corners shared by the features of a stage
+//17/10/2026  1.12      UTD DARClab                       Compiled cascade (make host_compiled)
+//17/10/2026  1.13      UTD DARClab                       Cascades loaded at run time (haar_cascade.cpp)
+//17/10/2026  1.14      UTD DARClab                       Layout in cascade_layout.cpp, mapped cascade files
+//17/10/2026  1.15      UTD DARClab                       SIMD integral image rows
+//17/10/2026  1.16      UTD DARClab                       Down-sampling fused into the integral image
+//17/10/2026  1.17      UTD DARClab                       Feature-scaling scan mode
+//17/10/2026  1.18      UTD DARClab                       Variance normalization of a row of windows
+//17/10/2026  1.19      UTD DARClab                       Variance floor
+//17/10/2026  1.20      UTD DARClab                       Regions of interest
+//17/10/2026  1.21      UTD DARClab                       Coarse-to-fine adaptive scan
+//18/10/2026  1.22      UTD DARClab                       Scale factor and shift step checked in setParams
+//18/10/2026  1.23      UTD DARClab                       Unused integral pointers dropped from setImageForCascadeClassifier
+//18/10/2026  1.24      UTD DARClab                       Candidates not limited to MAX_NUM_FACE
+//18/10/2026  1.25      UTD DARClab                       Scaled features keyed on the factor value, for the SystemC types
+//18/10/2026  1.26      UTD DARClab                       32-bit frame integrals when the windows allow, scalar engine only for SCAN_FEATURES
+//18/10/2026  1.27      UTD DARClab                       Coarse stride checked in setParams
+//18/10/2026  1.28      UTD DARClab                       MAX_NUM_FACE candidate limit of the module kept on 360x240 frames
+//============================================================================================
+
+#include "define.h"
+#include "facedetect_host.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
+#include "integral_simd.h"
+
+#ifdef COMPILED_CASCADE
+/* make host_compiled: the stages as straight-line code, written by gen_cascade.exe */
+#include "cascade_compiled.inc"
+#endif
+
+static int myAbs(int n)
+{
+  if (n >= 0)
+    return n;
+  else
+    return -n;
+}
+
+/* rounding function */
+inline  int  myRound( fx_wide_round_t value )
+{
+  return (int)(value + (fx_wide_round_t)0.5);
+}
+
+/* a/b rounded to the nearest integer, halves away from 0, for b > 0 */
+static int64_t roundDiv( int64_t a, int64_t b)
+{
+    if( a >= 0 )
+        return (a + b/2)/b;
+    return -((-a + b/2)/b);
+}
+
+/*******************************************************
+ * Function: detectObjects
+ * Description: It calls all the major steps
+ ******************************************************/
+
+void facedetect_host::detectObjects( MySize minSize, fx_scale_t scaleFactor, int minNeighbors, int shift_step)
+{
+
+    /* group overlaping windows */
+    const fx_scale_t GROUP_EPS = 0.4;
+
+    buildPyramid( minSize, scaleFactor);
+    findCandidates( shift_step);
+
+    if( minNeighbors != 0)
+    {
+        groupRectangles( minNeighbors, GROUP_EPS);
+    }
+
+}
+
+/*******************************************************
+ * Function: findCandidates
+ * Description: the cascade over all levels of the
+ * pyramid, the windows that pass are left in
+ * face_coordinate before grouping
+ ******************************************************/
+void facedetect_host::findCandidates( int shift_step)
+{
+    int k;
+
+    /* feature-scaling mode: the only integral images of the frame */
+    if( scanMode == SCAN_FEATURES )
+        buildFrameIntegral( in_img_buffer);
+
+    /* the levels and the row bands are independent, they can be processed in any order */
+    if( tracking_scan )
+        buildTrackingTasks( threads, bandRows, shift_step);
+    else
+        buildTasks( threads, bandRows, shift_step);
+    runTasks( threads, shift_step);
+
+    /* collect the faces in the order of the serial loop */
+    face_coordinate.clear();
+    scan_stats.frames++;
+    for( k = 0; k < (int)tasks.size(); k++ )
+    {
+        scan_stats.windows += task_windows[k];
+        scan_stats.skipped += task_skipped[k];
+        face_coordinate.insert( face_coordinate.end(), task_faces[k].begin(), task_faces[k].end());
+    }
+    /* the facedetect module keeps the first MAX_NUM_FACE-1 windows, larger frames keep them all */
+    if( frame_width == IMAGE_WIDTH && frame_height == IMAGE_HEIGHT && (int)face_coordinate.size() > MAX_NUM_FACE-1 )
+        face_coordinate.resize(MAX_NUM_FACE-1);
+    face_number = face_coordinate.size();
+}
+
+void facedetect_host::buildPyramid( MySize minSize, fx_scale_t scaleFactor)
+{
+    /* scaling factor */
+    fx_wide_factor_t factor;
+
+    /* window size of the training set */
+    MySize winSize0 = cascadeObj.orig_window_size;
+
+    /* iterate over the image pyramid */
+    levels.clear();
+    pyramid_rows = 0;
+    for( factor = 1; ; factor *= scaleFactor)
+    {
+        /* size of the image scaled up */
+        MySize winSize = { myRound(winSize0.width*factor), myRound(winSize0.height*factor) };
+
+        /* size of the image scaled down (from bigger to smaller) */
+        MySize sz = { ( frame_width/factor ), ( frame_height/factor ) };
+
+        /* break if the scale downed image is smaller than the window */
+        if( sz.width < 24 || sz.height < 24 )
+            break;
+
+        /* if a minSize different from the original detection window is specified, continue to the next scaling */
+        if( winSize.width < minSize.width || winSize.height < minSize.height )
+            continue;
+
+        PyramidLevel level = { factor, winSize, sz, pyramid_rows };
+        levels.push_back(level);
+        pyramid_rows += sz.height;
+    }
+
+    buildScanRegions();
+}
+
+/* smallest level coordinate whose window starts at 'frame' or after in the frame, as recordFace rounds it */
+static int firstWindowAt( int frame, fx_wide_factor_t factor)
+{
+    int v = (int)(frame/factor.to_double()) - 1;
+
+    if( v < 0 )
+        v = 0;
+    while( v > 0 && myRound((v-1)*factor) >= frame )
+        v--;
+    while( myRound(v*factor) < frame )
+        v++;
+    return v;
+}
+
+/*******************************************************
+ * The regions of a level made disjoint, so no window is
+ * scanned twice: the rows are cut where a region starts
+ * or ends, the overlapping column ranges of each slice
+ * of rows are merged, and consecutive slices with the
+ * same column ranges are joined again. The result is in
+ * row order, then column order.
+ ******************************************************/
+static void disjointRegions( std::vector<DetectTask>& regions)
+{
+    int i, k, n;
+    bool same;
+    std::vector<int> cuts;
+    std::vector<DetectTask> slice, result;
+    size_t last_begin = 0;
+
+    for( i = 0; i < (int)regions.size(); i++ )
+    {
+        cuts.push_back(regions[i].y_begin);
+        cuts.push_back(regions[i].y_end);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    for( k = 0; k+1 < (int)cuts.size(); k++ )
+    {
+        slice.clear();
+        for( i = 0; i < (int)regions.size(); i++ )
+        {
+            if( regions[i].y_begin <= cuts[k] && cuts[k+1] <= regions[i].y_end )
+                slice.push_back(regions[i]);
+        }
+        std::sort(slice.begin(), slice.end(), [](const DetectTask& a, const DetectTask& b) { return a.x_begin < b.x_begin; });
+
+        /* merged column ranges of the slice */
+        n = 0;
+        for( i = 0; i < (int)slice.size(); i++ )
+        {
+            if( n > 0 && slice[i].x_begin <= slice[n-1].x_end )
+            {
+                if( slice[i].x_end > slice[n-1].x_end )
+                    slice[n-1].x_end = slice[i].x_end;
+            }
+            else
+                slice[n++] = slice[i];
+        }
+        slice.resize(n);
+
+        /* the same ranges as the slice above it: extend those regions */
+        same = (n > 0 && result.size() - last_begin == (size_t)n && result.back().y_end == cuts[k]);
+        for( i = 0; i < n && same; i++ )
+            same = result[last_begin + i].x_begin == slice[i].x_begin && result[last_begin + i].x_end == slice[i].x_end;
+        if( same )
+        {
+            for( i = 0; i < n; i++ )
+                result[last_begin + i].y_end = cuts[k+1];
+            continue;
+        }
+
+        last_begin = result.size();
+        for( i = 0; i < n; i++ )
+        {
+            slice[i].y_begin = cuts[k];
+            slice[i].y_end = cuts[k+1];
+            result.push_back(slice[i]);
+        }
+    }
+    regions.swap(result);
+}
+
+/*******************************************************
+ * Function: buildScanRegions
+ * Description: the windows of each level to scan, the
+ * whole level, or for each region of interest the
+ * windows lying inside it: x from the first window
+ * starting at its left edge to the last one ending at
+ * its right edge, and the same for y. A level whose
+ * windows are larger than all the regions gets none.
+ ******************************************************/
+void facedetect_host::buildScanRegions(void)
+{
+    int i, l;
+
+    scan_regions.assign(levels.size(), std::vector<DetectTask>());
+    for( l = 0; l < (int)levels.size(); l++ )
+    {
+        const PyramidLevel& level = levels[l];
+        int rows = level.sz.height-25+1;
+        int x2 = level.sz.width-24;
+
+        if( roi_rects.empty() )
+        {
+            DetectTask region = { l, 0, rows, 0, level.sz.width };
+            scan_regions[l].push_back(region);
+            continue;
+        }
+
+        for( i = 0; i < (int)roi_rects.size(); i++ )
+        {
+            const MyRect& r = roi_rects[i];
+            DetectTask region = { l,
+                                  firstWindowAt( r.y, level.factor), firstWindowAt( r.y + r.height - level.winSize.height + 1, level.factor),
+                                  firstWindowAt( r.x, level.factor), firstWindowAt( r.x + r.width - level.winSize.width + 1, level.factor) };
+
+            if( region.y_end > rows ) region.y_end = rows;
+            if( region.x_end > x2 ) region.x_end = x2;
+            if( r.width >= level.winSize.width && r.height >= level.winSize.height &&
+                region.y_begin < region.y_end && region.x_begin < region.x_end )
+                scan_regions[l].push_back(region);
+        }
+        disjointRegions( scan_regions[l]);
+    }
+}
+
+/*******************************************************
+ * The regions of a mask: bounding boxes of its
+ * 8-connected regions of non-zero pixels, from the runs
+ * of each row joined to the runs they touch in the row
+ * above (union-find on the run labels).
+ ******************************************************/
+static void maskRegions( const uint8_t* mask, int width, int height, std::vector<MyRect>& rects)
+{
+    struct Run { int x_begin, x_end, label; };
+    int x, y, i, j, k, a, b;
+    std::vector<Run> above, row;
+    std::vector<int> parent;
+    std::vector<MyRect> box;
+
+    for( y = 0; y < height; y++ )
+    {
+        const uint8_t* line = mask + y*width;
+
+        row.clear();
+        for( x = 0; x < width; x++ )
+        {
+            if( line[x] == 0 )
+                continue;
+            Run run = { x, x, (int)parent.size() };
+            while( x+1 < width && line[x+1] != 0 )
+                x++;
+            run.x_end = x + 1;
+            MyRect r = { run.x_begin, y, run.x_end - run.x_begin, 1 };
+            parent.push_back(run.label);
+            box.push_back(r);
+            row.push_back(run);
+        }
+
+        /* runs of the row above overlapping or touching at a corner */
+        for( i = 0, j = 0; i < (int)row.size(); i++ )
+        {
+            while( j < (int)above.size() && above[j].x_end < row[i].x_begin )
+                j++;
+            for( k = j; k < (int)above.size() && above[k].x_begin <= row[i].x_end; k++ )
+            {
+                for( a = row[i].label; parent[a] != a; a = parent[a] = parent[parent[a]] );
+                for( b = above[k].label; parent[b] != b; b = parent[b] = parent[parent[b]] );
+                if( a != b )
+                    parent[(a > b) ? a : b] = (a > b) ? b : a;
+            }
+        }
+        above.swap(row);
+    }
+
+    /* the box of each region, at its root label */
+    for( i = 0; i < (int)parent.size(); i++ )
+    {
+        for( a = i; parent[a] != a; a = parent[a] );
+        if( a == i )
+            continue;
+        x = (box[a].x < box[i].x) ? box[a].x : box[i].x;
+        y = (box[a].y < box[i].y) ? box[a].y : box[i].y;
+        box[a].width = ((box[a].x + box[a].width > box[i].x + box[i].width) ? box[a].x + box[a].width : box[i].x + box[i].width) - x;
+        box[a].height = ((box[a].y + box[a].height > box[i].y + box[i].height) ? box[a].y + box[a].height : box[i].y + box[i].height) - y;
+        box[a].x = x;
+        box[a].y = y;
+    }
+
+    rects.clear();
+    for( i = 0; i < (int)parent.size(); i++ )
+    {
+        if( parent[i] == i )
+            rects.push_back(box[i]);
+    }
+}
+
+/* estimated cost of the windows at y_bias = y_begin to y_end-1, x = x_begin to x_end-1 of a level */
+static long taskCost( const PyramidLevel& level, int y_begin, int y_end, int x_begin, int x_end, int shift_step)
+{
+    int x2 = level.sz.width - 24;
+    long windows_per_row, cols;
+
+    if( x_end > x2 )
+        x_end = x2;
+    windows_per_row = (x_end > x_begin) ? (x_end - x_begin + shift_step-1)/shift_step : 0;
+    /* columns of the integral image, the whole level width for a full row */
+    cols = (x_end > x_begin) ? x_end - x_begin + 24 : 0;
+
+    /**************************************************
+    * most windows leave the cascade in the first two
+    * stages, which cost about as much as down-sampling
+    * and integrating 4 pixels; the halo rows are paid
+    * again by every band
+    **************************************************/
+    return (y_end - y_begin)*windows_per_row + (y_end - y_begin + 24)*cols/4;
+}
+
+/*******************************************************
+ * Function: buildTasks
+ * Description: splits the y_bias range of every level,
+ * or of its regions of interest (scan_regions), into
+ * bands. With band_rows > 0 every band has that
+ * many window rows. Otherwise the band height of each
+ * level is chosen so that a band costs about 1/4 of
+ * the work of a thread: enough tasks for the stealing
+ * to even out the threads, but few enough that the 24
+ * halo rows of every band stay cheap.
+ ******************************************************/
+void facedetect_host::buildTasks( int nthreads, int band_rows, int shift_step)
+{
+    int i, l;
+
+    setBandTarget( nthreads, shift_step);
+
+    tasks.clear();
+    task_cost.clear();
+    for( l = 0; l < (int)levels.size(); l++ )
+    {
+        for( i = 0; i < (int)scan_regions[l].size(); i++ )
+            addTasks( l, scan_regions[l][i].y_begin, scan_regions[l][i].y_end, scan_regions[l][i].x_begin, scan_regions[l][i].x_end, band_rows, shift_step);
+    }
+}
+
+/* the cost of a band: about 1/4 of the full-scan work of a thread, 0 for whole levels */
+void facedetect_host::setBandTarget( int nthreads, int shift_step)
+{
+    const int TASKS_PER_THREAD = 4;
+    int i, l;
+    long total = 0;
+
+    for( l = 0; l < (int)levels.size(); l++ )
+    {
+        for( i = 0; i < (int)scan_regions[l].size(); i++ )
+            total += taskCost(levels[l], scan_regions[l][i].y_begin, scan_regions[l][i].y_end, scan_regions[l][i].x_begin, scan_regions[l][i].x_end, shift_step);
+    }
+    band_target = 0;
+    if( nthreads > 1 )
+        band_target = total/(nthreads*TASKS_PER_THREAD);
+}
+
+/* bands of the windows at y_bias = y_begin to y_end-1, x = x_begin to x_end-1 of level l */
+void facedetect_host::addTasks( int l, int y_begin, int y_end, int x_begin, int x_end, int band_rows, int shift_step)
+{
+    const int MIN_BAND_ROWS = 8;
+    int y, level_band_rows;
+    long row_cost;
+
+    level_band_rows = band_rows;
+    if( level_band_rows <= 0 )
+    {
+        level_band_rows = y_end - y_begin;
+        /* cost of one more row of the band */
+        row_cost = taskCost(levels[l], 0, 2, x_begin, x_end, shift_step) - taskCost(levels[l], 0, 1, x_begin, x_end, shift_step);
+        if( band_target > 0 && row_cost > 0 )
+        {
+            level_band_rows = (band_target + row_cost-1)/row_cost;
+            if( level_band_rows < MIN_BAND_ROWS )
+                level_band_rows = MIN_BAND_ROWS;
+        }
+    }
+
+    for( y = y_begin; y < y_end; y += level_band_rows )
+    {
+        DetectTask task = { l, y, (y + level_band_rows < y_end) ? y + level_band_rows : y_end, x_begin, x_end };
+        tasks.push_back(task);
+        task_cost.push_back(taskCost(levels[l], task.y_begin, task.y_end, x_begin, x_end, shift_step));
+    }
+}
+
+/*******************************************************
+ * Function: buildTrackingTasks
+ * Description: temporal-coherence scan. For each face
+ * of the previous frame, the windows within half a face
+ * width of it are scanned at the level whose window
+ * size is closest to the face and at the levels just
+ * above and below, as the face may move and change size
+ * a little between frames. Overlapping regions of a
+ * level are merged so no window is scanned twice, and
+ * they are kept within the regions of interest.
+ ******************************************************/
+void facedetect_host::buildTrackingTasks( int nthreads, int band_rows, int shift_step)
+{
+    int i, j, l, nearest;
+    bool merged;
+    std::vector< std::vector<DetectTask> > regions(levels.size());
+
+    setBandTarget( nthreads, shift_step);
+
+    for( i = 0; i < (int)prev_faces.size(); i++ )
+    {
+        MyRect r = prev_faces[i];
+        double margin = 0.5*r.width;
+
+        nearest = 0;
+        for( l = 1; l < (int)levels.size(); l++ )
+        {
+            if( myAbs(levels[l].winSize.width - r.width) < myAbs(levels[nearest].winSize.width - r.width) )
+                nearest = l;
+        }
+
+        for( l = nearest-1; l <= nearest+1; l++ )
+        {
+            if( l < 0 || l >= (int)levels.size() )
+                continue;
+
+            double factor = levels[l].factor.to_double();
+            int rows = levels[l].sz.height-25+1;
+            int x2 = levels[l].sz.width-24;
+            DetectTask region = { l,
+                                  (int)floor((r.y - margin)/factor), (int)ceil((r.y + margin)/factor) + 1,
+                                  (int)floor((r.x - margin)/factor), (int)ceil((r.x + margin)/factor) + 1 };
+
+            if( region.y_begin < 0 ) region.y_begin = 0;
+            if( region.y_end > rows ) region.y_end = rows;
+            if( region.x_begin < 0 ) region.x_begin = 0;
+            if( region.x_end > x2 ) region.x_end = x2;
+            if( region.y_begin < region.y_end && region.x_begin < region.x_end )
+                regions[l].push_back(region);
+        }
+    }
+
+    tasks.clear();
+    task_cost.clear();
+    for( l = 0; l < (int)levels.size(); l++ )
+    {
+        /* merge overlapping regions into their bounding box until none overlap */
+        do
+        {
+            merged = false;
+            for( i = 0; i < (int)regions[l].size() && !merged; i++ )
+            {
+                for( j = i+1; j < (int)regions[l].size() && !merged; j++ )
+                {
+                    DetectTask& a = regions[l][i];
+                    DetectTask& b = regions[l][j];
+                    if( a.y_begin < b.y_end && b.y_begin < a.y_end && a.x_begin < b.x_end && b.x_begin < a.x_end )
+                    {
+                        a.y_begin = (a.y_begin < b.y_begin) ? a.y_begin : b.y_begin;
+                        a.y_end = (a.y_end > b.y_end) ? a.y_end : b.y_end;
+                        a.x_begin = (a.x_begin < b.x_begin) ? a.x_begin : b.x_begin;
+                        a.x_end = (a.x_end > b.x_end) ? a.x_end : b.x_end;
+                        regions[l].erase(regions[l].begin() + j);
+                        merged = true;
+                    }
+                }
+            }
+        } while( merged );
+
+        /* top to bottom, then left to right, like the serial scan */
+        std::sort(regions[l].begin(), regions[l].end(), [](const DetectTask& a, const DetectTask& b)
+        {
+            return (a.y_begin != b.y_begin) ? a.y_begin < b.y_begin : a.x_begin < b.x_begin;
+        });
+
+        /* within the regions of interest, which are disjoint */
+        for( i = 0; i < (int)regions[l].size(); i++ )
+        {
+            for( j = 0; j < (int)scan_regions[l].size(); j++ )
+            {
+                DetectTask r = regions[l][i];
+                const DetectTask& s = scan_regions[l][j];
+                if( r.y_begin < s.y_begin ) r.y_begin = s.y_begin;
+                if( r.y_end > s.y_end ) r.y_end = s.y_end;
+                if( r.x_begin < s.x_begin ) r.x_begin = s.x_begin;
+                if( r.x_end > s.x_end ) r.x_end = s.x_end;
+                if( r.y_begin < r.y_end && r.x_begin < r.x_end )
+                    addTasks( l, r.y_begin, r.y_end, r.x_begin, r.x_end, band_rows, shift_step);
+            }
+        }
+    }
+}
+
+/*******************************************************
+ * Function: needFullScan
+ * Description: temporal-coherence mode, decides if the
+ * frame gets a full scan: the first frame, every
+ * trackInterval-th frame, and a frame whose sample of
+ * one pixel in SCENE_SAMPLE_STEP x SCENE_SAMPLE_STEP
+ * differs from the previous frame by more than
+ * sceneChange grey levels on average
+ ******************************************************/
+bool facedetect_host::needFullScan( const uint8_t* img)
+{
+    const int SCENE_SAMPLE_STEP = 8;
+    int x, y, n = 0;
+    long diff = 0;
+    bool first = prev_sample.empty();
+    bool scene_change;
+
+    prev_sample.resize((frame_height/SCENE_SAMPLE_STEP)*(frame_width/SCENE_SAMPLE_STEP));
+    for( y = 0; y < frame_height/SCENE_SAMPLE_STEP; y++ )
+    {
+        for( x = 0; x < frame_width/SCENE_SAMPLE_STEP; x++ )
+        {
+            unsigned char v = img[y*SCENE_SAMPLE_STEP*frame_width + x*SCENE_SAMPLE_STEP];
+            diff += myAbs(v - prev_sample[n]);
+            prev_sample[n++] = v;
+        }
+    }
+    scene_change = !first && diff > (long)sceneChange*n;
+
+    frames_since_full++;
+    if( first || scene_change || frames_since_full >= trackInterval )
+    {
+        frames_since_full = 0;
+        tracking_stats.full_scans++;
+        if( scene_change )
+            tracking_stats.scene_changes++;
+        return true;
+    }
+    tracking_stats.tracking_scans++;
+    return false;
+}
+
+/*******************************************************
+ * Function: runTasks
+ * Description: the tasks go through the work-stealing
+ * scheduler, each thread with its own worker
+ ******************************************************/
+void facedetect_host::runTasks( int nthreads, int shift_step)
+{
+    int k;
+    int ntasks = tasks.size();
+
+    task_faces.resize(ntasks);
+    task_windows.assign(ntasks, 0);
+    task_skipped.assign(ntasks, 0);
+    for( k = 0; k < ntasks; k++ )
+        task_faces[k].clear();
+
+    if( nthreads > ntasks )
+        nthreads = ntasks;
+    if( nthreads < 1 )
+        nthreads = 1;
+    while( (int)workers.size() < nthreads )
+        workers.push_back(new facedetect_worker());
+    for( k = 0; k < nthreads; k++ )
+    {
+        workers[k]->setFrameSize( frame_width, frame_height);
+        workers[k]->setCascade( layout);
+        workers[k]->setVarianceFloor( varianceFloor);
+        workers[k]->setAdaptiveScan( coarseStep, refineStage);
+    }
+
+    scheduler.run( nthreads, task_cost, [this, shift_step](int t, int k)
+    {
+        const PyramidLevel& level = levels[tasks[k].level];
+        unsigned char* level_image = NULL;
+        if( scanMode == SCAN_FEATURES )
+        {
+            /* a wide sum comes with a wide squared sum */
+            if( !frame_sum_wide.empty() )
+                task_windows[k] = workers[t]->detectBandScaled( frame_sum_wide.data(), frame_sqsum_wide.data(), level, tasks[k], shift_step, task_faces[k]);
+            else if( !frame_sqsum_wide.empty() )
+                task_windows[k] = workers[t]->detectBandScaled( frame_sum.data(), frame_sqsum_wide.data(), level, tasks[k], shift_step, task_faces[k]);
+            else
+                task_windows[k] = workers[t]->detectBandScaled( frame_sum.data(), frame_sqsum.data(), level, tasks[k], shift_step, task_faces[k]);
+            task_skipped[k] = workers[t]->varianceSkipped();
+            return;
+        }
+        if( pyramid_images != NULL )
+            level_image = pyramid_images + level.first_row*frame_width;
+        task_windows[k] = workers[t]->detectBand( in_img_buffer, level_image, level, tasks[k], shift_step, engine, task_faces[k]);
+        task_skipped[k] = workers[t]->varianceSkipped();
+    });
+}
+
+/* integral image of the pixels, or of their squares, wrapping around at the width of T */
+template<typename T>
+static void frameIntegral( const uint8_t* img, int width, int height, bool squared, T* sum)
+{
+    int x, y;
+    T s;
+    unsigned int it;
+
+    for( y = 0; y < height; y++ )
+    {
+        const uint8_t* src = img + y*width;
+        T* row = sum + y*width;
+
+        s = 0;
+        for( x = 0; x < width; x++ )
+        {
+            it = src[x];
+            s += squared ? it*it : it;
+            row[x] = (y != 0) ? s + row[x - width] : s;
+        }
+    }
+}
+
+/* the buffer of one of the integral images, the other one is released */
+template<typename T, typename U>
+static T* frameBuffer( std::vector<T>& used, std::vector<U>& unused, int size)
+{
+    std::vector<U>().swap(unused);
+    if( (int)used.size() < size )
+        used.resize(size);
+    return used.data();
+}
+
+/*******************************************************
+ * Function: buildFrameIntegral
+ * Description: integral and squared integral images of
+ * the whole frame for the feature-scaling mode, with
+ * the same convention as integralImages (the value at
+ * (x, y) includes the pixel at (x, y)). Every rectangle
+ * of a feature lies in its window, so with the 32-bit
+ * wrap-around of the pyramid mode the rectangle sums are
+ * exact as long as the sums of the largest window fit
+ * 32 bits; otherwise that image is 64-bit. At 360x240
+ * both are 32-bit, at 3840x2160 only the squared sum
+ * is 64-bit.
+ ******************************************************/
+void facedetect_host::buildFrameIntegral( const uint8_t* img)
+{
+    int l;
+    int size = frame_width*frame_height;
+    uint64_t area = 0;
+
+    for( l = 0; l < (int)levels.size(); l++ )
+    {
+        if( (uint64_t)levels[l].winSize.width*levels[l].winSize.height > area )
+            area = (uint64_t)levels[l].winSize.width*levels[l].winSize.height;
+    }
+
+    if( PGM_MAXGRAY*area > UINT32_MAX )
+        frameIntegral( img, frame_width, frame_height, false, frameBuffer( frame_sum_wide, frame_sum, size));
+    else
+        frameIntegral( img, frame_width, frame_height, false, frameBuffer( frame_sum, frame_sum_wide, size));
+
+    if( PGM_MAXGRAY*PGM_MAXGRAY*area > UINT32_MAX )
+        frameIntegral( img, frame_width, frame_height, true, frameBuffer( frame_sqsum_wide, frame_sqsum, size));
+    else
+        frameIntegral( img, frame_width, frame_height, true, frameBuffer( frame_sqsum, frame_sqsum_wide, size));
+}
+
+/*******************************************************
+ * Function: detectBand
+ * Description: down-sampling, integral image and
+ * cascade for the windows at y_bias = y_begin to
+ * y_end-1 and x = x_begin to x_end-1 of one level of
+ * the pyramid. The level is read from level_image when
+ * it has been down-sampled already (facedetect_stream),
+ * otherwise the integral image rows sample the frame
+ * directly through the index tables of the level, and no
+ * down-sampled copy of the level is written. The
+ * integral image window starts at row
+ * y_begin and at the column of the first window: the
+ * values differ from those of a window started at (0,0)
+ * by the same amount at the four corners of every
+ * rectangle, so the rectangle sums (32-bit wrap-around
+ * included) are the same. A band wider than
+ * MAX_WINDOW_COLS is scanned in column tiles, each with
+ * its own integral image window.
+ ******************************************************/
+long facedetect_worker::detectBand( const uint8_t* img, unsigned char* level_image, const PyramidLevel& level, const DetectTask& task, int shift_step, int engine, std::vector<MyRect>& faces)
+{
+    int y_begin = task.y_begin;
+    int y_end = task.y_end;
+    /* first window on the x grid of a full scan, and the columns the windows cover */
+    int x_begin = (task.x_begin + shift_step-1)/shift_step*shift_step;
+    int x_end = (task.x_end < level.sz.width-24) ? task.x_end : level.sz.width-24;
+    /* windows per column tile, on the x grid */
+    int tile_windows = (MAX_WINDOW_COLS - 24)/shift_step*shift_step;
+    int x;
+    long windows = 0;
+    size_t first_face = faces.size();
+    MySize sz = level.sz;
+
+    variance_skipped = 0;
+    if( x_end <= x_begin )
+        return 0;
+
+    in_img_buffer = img;
+    this->engine = engine;
+    face_list = &faces;
+
+    /***************************************
+    * Image pyramid by nearest neighbor
+    * down-sampling: the pixel of each level
+    * row and column, read by integralImages
+    **************************************/
+    level_src = level_image;
+    if( level_image == NULL )
+        scaleIndexTables( sz.width, sz.height);
+
+    /* the adaptive scan also reads the coarse windows up to a coarse stride around the tile */
+    if( coarse_step > 1 )
+        tile_windows = (MAX_WINDOW_COLS - 24 - 2*(coarse_step-1)*shift_step)/shift_step*shift_step;
+
+    for( x = x_begin; x < x_end; x += tile_windows )
+    {
+        if( coarse_step > 1 )
+            windows += scanAdaptive( level, y_begin, y_end, x, (x_end - x < tile_windows) ? x_end : x + tile_windows, shift_step);
+        else
+            windows += scanColumns( level, y_begin, y_end, x, (x_end - x < tile_windows) ? x_end : x + tile_windows, shift_step);
+    }
+
+    /* back to the row by row order of a single tile, x order is kept within a row */
+    if( x_end - x_begin > tile_windows )
+        std::stable_sort( faces.begin() + first_face, faces.end(), [](const MyRect& a, const MyRect& b) { return a.y < b.y; });
+
+    in_img_buffer = NULL;
+    level_src = NULL;
+    face_list = NULL;
+
+    return windows;
+}
+
+/*******************************************************
+ * Function: scanColumns
+ * Description: integral image and cascade for the
+ * windows at x = x_begin to x_end-1 of the rows of a
+ * band, the integral image window is at most
+ * MAX_WINDOW_COLS wide. Returns the number of windows.
+ ******************************************************/
+long facedetect_worker::scanColumns( const PyramidLevel& level, int y_begin, int y_end, int x_begin, int x_end, int shift_step)
+{
+    int y_bias;
+    int cols = x_end + 24 - x_begin;
+
+    scan_x_offset = x_begin;
+
+    /***************************************************
+    * Compute-intensive step:
+    * At each scale of the image pyramid,
+    * compute a new integral and squared integral image
+    ***************************************************/
+    integralImages(y_begin, int_img_buffer.data(), sq_int_buffer.data(), cols, 25);
+    window_row = 0;
+
+    /**************************************************
+    * Note:
+    * Summing pixels within a haar window is done by
+    * using four corners of the integral image:
+    * http://en.wikipedia.org/wiki/Summed_area_table
+    *
+    * This function loads does not do computation.
+    * The computation is done next in ScaleImage_Invoker
+    *************************************************/
+    setImageForCascadeClassifier(  cols);
+
+    for(y_bias=y_begin; y_bias < y_end; y_bias++){
+        if(y_bias!=y_begin)
+            // move the ring window down and only compute the last row of pixels
+            integralmages_lastrow(int_img_buffer.data(), sq_int_buffer.data(), cols, y_bias);
+        setWindowRows( cols);
+
+        /****************************************************
+        * Process the current scale with the cascaded fitler.
+        * The main computations are invoked by this function.
+        ***************************************************/
+        ScaleImage_Invoker( level.factor, cols, shift_step, y_bias);
+    }
+
+    scan_x_offset = 0;
+    return (long)(y_end - y_begin)*((x_end - x_begin + shift_step-1)/shift_step);
+}
+
+/* the integral image window at window_row of the ring, cols wide */
+void facedetect_worker::setWindowRows( int cols)
+{
+#ifdef COMPILED_CASCADE
+    int r;
+#endif
+
+    sum_window = &int_img_buffer[window_row*cols];
+    sqsum_window = &sq_int_buffer[window_row*cols];
+#ifdef COMPILED_CASCADE
+    for( r = 0; r < 25; r++ )
+        window_rows[r] = sum_window + r*cols;
+#endif
+}
+
+/*******************************************************
+ * Function: scanAdaptive
+ * Description: coarse-to-fine scan of the windows at
+ * y_bias = y_begin to y_end-1, x = x_begin to x_end-1.
+ * The first pass runs the cascade on the coarse grid,
+ * every coarse_step-th row and every coarse_step-th
+ * window of the x grid of the level, and keeps the stage
+ * where each window left it (runCascadeClassifier
+ * returns -i). Around a coarse window that reached stage
+ * refine_stage, or passed, the windows of the full grid
+ * closer than one coarse stride are marked, and the
+ * second pass runs them. The coarse windows up to one
+ * stride outside the range are run too, so the result
+ * does not depend on the bands and tiles; only the
+ * windows of the range are reported, in row order.
+ * Returns the number of windows run.
+ ******************************************************/
+long facedetect_worker::scanAdaptive( const PyramidLevel& level, int y_begin, int y_end, int x_begin, int x_end, int shift_step)
+{
+    int stride = coarse_step*shift_step;
+    int rows = level.sz.height-25+1;
+    int x2 = level.sz.width-24;
+    /* coarse windows whose neighbourhood reaches the range */
+    int ey_begin = (y_begin - coarse_step+1 > 0) ? y_begin - coarse_step+1 : 0;
+    int ey_end = (y_end + coarse_step-1 < rows) ? y_end + coarse_step-1 : rows;
+    int ex_begin = (x_begin - stride + shift_step > 0) ? x_begin - stride + shift_step : 0;
+    int ex_end = (x_end + stride - shift_step < x2) ? x_end + stride - shift_step : x2;
+    int cols = ex_end + 24 - ex_begin;
+    /* windows of a row of the range, on the x grid from x_begin */
+    int nx = (x_end - x_begin + shift_step-1)/shift_step;
+    int x, y, k, n, i, j, result, first_row, last_row;
+    long windows = 0;
+    MyPoint p;
+
+    refine_mark.assign((size_t)(y_end - y_begin)*nx, 0);
+    refine_faces.clear();
+    scan_x_offset = ex_begin;
+    p.y = 0;
+
+    /* coarse pass, the integral image window goes down every row */
+    integralImages( ey_begin, int_img_buffer.data(), sq_int_buffer.data(), cols, 25);
+    window_row = 0;
+    setImageForCascadeClassifier( cols);
+    for( y = ey_begin; y < ey_end; y++ )
+    {
+        if( y != ey_begin )
+            integralmages_lastrow( int_img_buffer.data(), sq_int_buffer.data(), cols, y);
+        if( y % coarse_step != 0 )
+            continue;
+        setWindowRows( cols);
+
+        x = (ex_begin + stride-1)/stride*stride;
+        n = varianceNorms( x - ex_begin, ex_end - ex_begin, stride, cols, survivor_norm.data());
+        for( k = 0; k < n; k++, x += stride )
+        {
+            p.x = x - ex_begin;
+            result = 0;
+            if( survivor_norm[k] != 0 )
+                result = runCascadeClassifier( p, 0, cols, survivor_norm[k]);
+            windows++;
+
+            if( y >= y_begin && y < y_end && x >= x_begin && x < x_end )
+            {
+                refine_mark[(size_t)(y - y_begin)*nx + (x - x_begin)/shift_step] = 2;
+                if( result > 0 )
+                {
+                    MyPoint face = { x, y };
+                    refine_faces.push_back(face);
+                }
+            }
+
+            /* the neighbourhood of a deep window, within the range */
+            if( result > 0 || -result >= refine_stage )
+            {
+                for( i = y - coarse_step+1; i < y + coarse_step; i++ )
+                {
+                    if( i < y_begin || i >= y_end )
+                        continue;
+                    for( j = x - stride + shift_step; j < x + stride; j += shift_step )
+                    {
+                        if( j < x_begin || j >= x_end )
+                            continue;
+                        unsigned char& mark = refine_mark[(size_t)(i - y_begin)*nx + (j - x_begin)/shift_step];
+                        if( mark == 0 )
+                            mark = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    /* rows with marked windows */
+    first_row = y_end;
+    last_row = y_begin - 1;
+    for( y = y_begin; y < y_end; y++ )
+    {
+        for( k = 0; k < nx; k++ )
+        {
+            if( refine_mark[(size_t)(y - y_begin)*nx + k] == 1 )
+            {
+                if( first_row == y_end )
+                    first_row = y;
+                last_row = y;
+                break;
+            }
+        }
+    }
+
+    /* fine pass, on the marked rows, one run of marked windows at a time */
+    if( first_row <= last_row )
+    {
+        integralImages( first_row, int_img_buffer.data(), sq_int_buffer.data(), cols, 25);
+        window_row = 0;
+    }
+    for( y = first_row; y <= last_row; y++ )
+    {
+        const unsigned char* mark = &refine_mark[(size_t)(y - y_begin)*nx];
+
+        if( y != first_row )
+            integralmages_lastrow( int_img_buffer.data(), sq_int_buffer.data(), cols, y);
+        setWindowRows( cols);
+
+        for( k = 0; k < nx; k = j )
+        {
+            for( ; k < nx && mark[k] != 1; k++ );
+            for( j = k; j < nx && mark[j] == 1; j++ );
+            if( k == nx )
+                break;
+
+            x = x_begin + k*shift_step;
+            n = varianceNorms( x - ex_begin, x_begin + j*shift_step - ex_begin, shift_step, cols, survivor_norm.data());
+            for( i = 0; i < n; i++, x += shift_step )
+            {
+                windows++;
+                if( survivor_norm[i] == 0 )
+                    continue;
+                p.x = x - ex_begin;
+                if( runCascadeClassifier( p, 0, cols, survivor_norm[i]) > 0 )
+                {
+                    MyPoint face = { x, y };
+                    refine_faces.push_back(face);
+                }
+            }
+        }
+    }
+
+    /* the order of a full scan */
+    std::sort( refine_faces.begin(), refine_faces.end(), [](const MyPoint& a, const MyPoint& b)
+    {
+        return (a.y != b.y) ? a.y < b.y : a.x < b.x;
+    });
+    for( k = 0; k < (int)refine_faces.size(); k++ )
+        recordFace( refine_faces[k].x - ex_begin, refine_faces[k].y, level.factor, level.winSize);
+
+    scan_x_offset = 0;
+    return windows;
+}
+
+/* the whole level, for a pyramid built ahead of the cascade */
+void facedetect_worker::downsample( const uint8_t* img, const PyramidLevel& level, unsigned char* level_image)
+{
+    in_img_buffer = img;
+    nearestNeighbor( level_image, level.sz.width, level.sz.height, 0, level.sz.height);
+    in_img_buffer = NULL;
+}
+
+
+static unsigned int int_sqrt (unsigned int value)
+{
+    int i;
+    unsigned int a = 0, b = 0, c = 0;
+    for (i=0; i < (32 >> 1); i++)
+    {
+        c<<= 2;
+
+        c += value>>30;
+
+        value <<= 2;
+        a <<= 1;
+        b = (a<<1) | 1;
+        if (c >= b)
+        {
+            c -= b;
+            a++;
+        }
+    }
+    return a;
+}
+
+
+/*******************************************************
+ * The rectangle offsets only depend on the width of the
+ * integral image window, so the table of each width is
+ * built once and kept: the levels of a frame have
+ * different widths, but the next frames use the same
+ * ones. The RECT_CACHE_SIZE least recently used widths
+ * are kept.
+ ******************************************************/
+void facedetect_worker::setImageForCascadeClassifier( int width)
+{
+    int t, oldest = 0;
+
+    cascadeObj.inv_window_area = cascadeObj.orig_window_size.width*cascadeObj.orig_window_size.height;
+
+    rect_uses++;
+    for( t = 0; t < (int)rect_tables.size(); t++ )
+    {
+        if( rect_tables[t].width == width )
+        {
+            rect_tables[t].last_use = rect_uses;
+            scaled_rectangles_array = rect_tables[t].offsets.data();
+            corner_offsets = rect_tables[t].corners.data();
+#ifdef PACKED_CLASSIFIERS
+            classifiers = rect_tables[t].records;
+#endif
+            return;
+        }
+        if( rect_tables[t].last_use < rect_tables[oldest].last_use )
+            oldest = t;
+    }
+
+    if( (int)rect_tables.size() < RECT_CACHE_SIZE )
+    {
+        oldest = rect_tables.size();
+        rect_tables.push_back(RectOffsetTable());
+        rect_tables[oldest].offsets.resize(12*layout->count);
+        rect_tables[oldest].corners.resize(layout->stage_corners[layout->nstages]);
+#ifdef PACKED_CLASSIFIERS
+        rect_tables[oldest].storage.resize(layout->count*sizeof(WeakClassifier) + 64);
+        rect_tables[oldest].records = (WeakClassifier*)(((uintptr_t)rect_tables[oldest].storage.data() + 63) & ~(uintptr_t)63);
+#endif
+    }
+    rect_tables[oldest].width = width;
+    rect_tables[oldest].last_use = rect_uses;
+    buildRectOffsets( rect_tables[oldest].offsets.data(), width);
+    scaled_rectangles_array = rect_tables[oldest].offsets.data();
+    for( t = 0; t < layout->stage_corners[layout->nstages]; t++ )
+        rect_tables[oldest].corners[t] = width*layout->corner_y[t] + layout->corner_x[t];
+    corner_offsets = rect_tables[oldest].corners.data();
+#ifdef PACKED_CLASSIFIERS
+    buildClassifiers( rect_tables[oldest].records, scaled_rectangles_array);
+    classifiers = rect_tables[oldest].records;
+#endif
+}
+
+#ifdef PACKED_CLASSIFIERS
+/* one record per weak classifier, in the order of the layout */
+void facedetect_worker::buildClassifiers( WeakClassifier* records, const rect_offset_t* offsets)
+{
+    int j, k;
+
+    for( j = 0; j < layout->count; j++ )
+    {
+        for( k = 0; k < 12; k++ )
+            records[j].offsets[k] = offsets[12*j + k];
+        for( k = 0; k < 3; k++ )
+            records[j].weights[k] = layout->weights[3*j + k];
+        records[j].tree_thresh = layout->tree_thresh[j];
+        records[j].alpha1 = layout->alpha1[j];
+        records[j].alpha2 = layout->alpha2[j];
+    }
+}
+#endif
+
+/****************************************
+* Load the index of the four corners
+* of the filter rectangle, in the order
+* of the layout
+**************************************/
+void facedetect_worker::buildRectOffsets( rect_offset_t* offsets, int width)
+{
+    int j, k;
+    MyRect tr;
+
+    /* loop over the features */
+    for( j = 0; j < layout->count; j++ )
+    {
+        const int* rect = &layout->rectangles[12*j];
+
+        /* loop over the number of rectangles */
+        for( k = 0; k < 3; k++ )
+        {
+            tr.x = rect[k*4];
+            tr.width = rect[2 + k*4];
+            tr.y = rect[1 + k*4];
+            tr.height = rect[3 + k*4];
+            if ( k == 2 && !CascadeLayout::hasThirdRect(rect) )
+            {
+                offsets[12*j + k*4] = RECT_OFFSET_NULL;
+                offsets[12*j + k*4 + 1] = RECT_OFFSET_NULL;
+                offsets[12*j + k*4 + 2] = RECT_OFFSET_NULL;
+                offsets[12*j + k*4 + 3] = RECT_OFFSET_NULL;
+            }
+            else
+            {
+                offsets[12*j + k*4] = width*(tr.y ) + (tr.x ) ;
+                offsets[12*j + k*4 + 1] = width*(tr.y ) + (tr.x  + tr.width);
+                offsets[12*j + k*4 + 2] = width*(tr.y  + tr.height) + (tr.x );
+                offsets[12*j + k*4 + 3] = width*(tr.y  + tr.height) + (tr.x  + tr.width);
+            }
+        } /* end of k loop*/
+    } /* end of j loop */
+}
+
+
+/****************************************************
+ * evalWeakClassifier:
+ * the actual computation of a haar filter.
+ * More info:
+ * http://en.wikipedia.org/wiki/Haar-like_features
+ *
+ * NRECTS is the number of rectangles of the feature,
+ * the alpha is selected with a mask instead of a branch
+ ***************************************************/
+template<int NRECTS>
+inline int facedetect_worker::evalWeakClassifier(int variance_norm_factor, int p_offset, int feature )
+{
+#ifdef PACKED_CLASSIFIERS
+    /* one cache line for everything but the integral image */
+    const WeakClassifier* f = classifiers + feature;
+    const rect_offset_t* r = f->offsets;
+    const int* w = f->weights;
+    int t = f->tree_thresh * variance_norm_factor;
+    int alpha1 = f->alpha1;
+    int alpha2 = f->alpha2;
+#else
+    const rect_offset_t* r = scaled_rectangles_array + 12*feature;
+    const int* w = &layout->weights[3*feature];
+    /* the node threshold is multiplied by the standard deviation of the image */
+    int t = layout->tree_thresh[feature] * variance_norm_factor;
+    int alpha1 = layout->alpha1[feature];
+    int alpha2 = layout->alpha2[feature];
+#endif
+    const int* p = sum_window + p_offset;
+
+    int sum = (p[r[0]] - p[r[1]] - p[r[2]] + p[r[3]]) * w[0]
+            + (p[r[4]] - p[r[5]] - p[r[6]] + p[r[7]]) * w[1];
+
+    if( NRECTS == 3 )
+        sum += (p[r[8]] - p[r[9]] - p[r[10]] + p[r[11]]) * w[2];
+
+    int pass = -(sum >= t);
+    return (alpha2 & pass) | (alpha1 & ~pass);
+}
+
+void facedetect_worker::updatePvalue(  int* sum, int* sqsum, int p_offset, int pq_offset, int width)
+{
+    cascadeObj.p0 = sum[0+p_offset] ;
+    cascadeObj.p1 = sum[cascadeObj.orig_window_size.width - 1+p_offset] ;
+    cascadeObj.p2 = sum[width*(cascadeObj.orig_window_size.height - 1)+p_offset];
+    cascadeObj.p3 = sum[width*(cascadeObj.orig_window_size.height - 1) + cascadeObj.orig_window_size.width - 1+p_offset];
+    cascadeObj.pq0 = sqsum[0+pq_offset];
+    cascadeObj.pq1 = sqsum[cascadeObj.orig_window_size.width - 1+pq_offset] ;
+    cascadeObj.pq2 = sqsum[width*(cascadeObj.orig_window_size.height - 1)+pq_offset];
+    cascadeObj.pq3 = sqsum[width*(cascadeObj.orig_window_size.height - 1) + cascadeObj.orig_window_size.width - 1+pq_offset];
+}
+
+/**************************************************************************
+* Image normalization
+* mean is the mean of the pixels in the detection window
+* inv_window_area is 1 over the total number of pixels in the detection window
+*************************************************************************/
+unsigned int facedetect_worker::varianceNormFactor( int p_offset, int width)
+{
+    unsigned int mean;
+    unsigned int variance_norm_factor;
+
+    updatePvalue( sum_window, sqsum_window, p_offset, p_offset, width);
+
+    variance_norm_factor =  (cascadeObj.pq0 - cascadeObj.pq1 - cascadeObj.pq2 + cascadeObj.pq3);
+    mean = (cascadeObj.p0 - cascadeObj.p1 - cascadeObj.p2 + cascadeObj.p3);
+
+    variance_norm_factor = (variance_norm_factor*cascadeObj.inv_window_area);
+    variance_norm_factor =  variance_norm_factor - mean*mean;
+
+    if( variance_norm_factor > 0 )
+        variance_norm_factor = int_sqrt(variance_norm_factor);
+    else
+        variance_norm_factor = 1;
+
+    return variance_norm_factor;
+}
+
+/*******************************************************
+ * The normalization of a whole row of windows before
+ * their cascades: with SIMD the sums, the variance and
+ * the square root of 8 or 16 windows are computed
+ * together (varianceNormSimd), instead of the 16 steps
+ * of int_sqrt per window, which cost about as much as
+ * stage 0 for the many windows it rejects.
+ * With a variance floor, the flat windows (sky, walls,
+ * backgrounds) get a norm of 0, which variance_norm_factor
+ * never is, and the engines drop them before stage 0.
+ ******************************************************/
+int facedetect_worker::varianceNorms( int x_begin, int x_end, int step, int width, int* norm)
+{
+    int k = 0;
+    int n = (x_end > x_begin) ? (x_end - x_begin + step-1)/step : 0;
+    int area = (cascadeObj.orig_window_size.width - 1)*(cascadeObj.orig_window_size.height - 1);
+    CascadeView view;
+
+    if( norm_lanes > 0 && n >= norm_lanes )
+    {
+        setCascadeView( &view, width);
+        k = varianceNormSimd( &view, norm_lanes, x_begin, step, n, norm);
+    }
+    for( ; k < n; k++ )
+    {
+        norm[k] = varianceNormFactor( x_begin + k*step, width);
+        /* the sums left by updatePvalue */
+        if( var_floor > 0 && belowVarianceFloor( cascadeObj.p0 - cascadeObj.p1 - cascadeObj.p2 + cascadeObj.p3,
+                                                 cascadeObj.pq0 - cascadeObj.pq1 - cascadeObj.pq2 + cascadeObj.pq3, area) )
+            norm[k] = 0;
+    }
+    countSkipped( norm, n);
+    return n;
+}
+
+/*******************************************************
+ * The variance floor is a test on the true variance of
+ * the pixels of the variance window (23 x 23 pixels, see
+ * updatePvalue): area*sqsum - sum*sum is area^2 times
+ * the variance, exact in 64 bits. variance_norm_factor
+ * itself cannot be used, its inv_window_area of 576 is
+ * not the pixel count and leaves it far from 0 for a
+ * flat window.
+ ******************************************************/
+bool facedetect_worker::belowVarianceFloor( int64_t sum, int64_t sqsum, int64_t area)
+{
+    return area*sqsum - sum*sum < var_floor*area*area;
+}
+
+void facedetect_worker::countSkipped( const int* norm, int n)
+{
+    int k;
+
+    if( var_floor <= 0 )
+        return;
+    for( k = 0; k < n; k++ )
+        variance_skipped += (norm[k] == 0);
+}
+
+/* variance_norm_factor of the window, from varianceNormFactor or varianceNorms */
+int facedetect_worker::runCascadeClassifier( MyPoint pt, int start_stage, int width, unsigned int variance_norm_factor)
+{
+
+    int p_offset;
+    int i, j;
+    int haar_counter = 0;
+    int stage_sum;
+
+    p_offset = pt.y * width + pt.x;
+
+#ifdef COMPILED_CASCADE
+    /* same features, thresholds and stage tests, with the table values as constants */
+    if( layout->builtin && start_stage == 0 && pt.y == 0 )
+        return runCompiledCascade( window_rows, pt.x, variance_norm_factor, layout->stage_limit);
+#endif
+
+    /**************************************************
+    * The major computation happens here.
+    * For each scale in the image pyramid,
+    * and for each shifted step of the filter,
+    * send the shifted window through cascade filter.
+    *
+    * Note:
+    *
+    * Stages in the cascade filter are independent.
+    * However, a face can be rejected by any stage.
+    * Running stages in parallel delays the rejection,
+    * which induces unnecessary computation.
+    *
+    * Filters in the same stage are also independent,
+    * except that filter results need to be merged,
+    * and compared with a per-stage threshold.
+    *************************************************/
+    for( i = start_stage; i < layout->nstages ; i++ )
+    {
+        stage_sum = 0;
+
+        /**************************************************
+        * Send the shifted window to the haar filters of
+        * the stage, the 2-rectangle ones first
+        **************************************************/
+        for( j = 0; j < layout->stage_two_rect[i]; j++ )
+            stage_sum += evalWeakClassifier<2>(variance_norm_factor, p_offset, haar_counter++);
+        for( ; j < layout->stage_features[i]; j++ )
+            stage_sum += evalWeakClassifier<3>(variance_norm_factor, p_offset, haar_counter++);
+
+        /**************************************************************
+        * threshold of the stage.
+        * If the sum is below the threshold,
+        * no faces are detected,
+        * and the search is abandoned at the i-th stage (-i).
+        * Otherwise, a face is detected (1)
+        **************************************************************/
+
+        /* the number "0.4" is empirically chosen for 5kk73 */
+        if( stage_sum < (fx_scale_t)0.4*layout->stage_thresh[i] ){
+            return -i;
+        } /* end of the per-stage thresholding */
+    } /* end of i loop */
+    return 1;
+}
+
+
+void facedetect_worker::ScaleImage_Invoker( fx_wide_factor_t factor, int sum_col, int shift_step, int y_bias)
+{
+
+    MyPoint p;
+
+    int result;
+    int x2, x, step;
+    int k, n;
+
+    MySize winSize0 = cascadeObj.orig_window_size;
+    MySize winSize;
+
+    winSize.width =  myRound(winSize0.width*factor);
+    winSize.height =  myRound(winSize0.height*factor);
+
+    /********************************************
+    * When filter window shifts to image boarder,
+    * some margin need to be kept
+    *********************************************/
+    x2 = sum_col - winSize0.width;
+    p.y = 0;
+    
+    step = shift_step;
+
+    /* the SIMD engine takes whole blocks of windows, the rest goes through the scalar loop */
+    x = 0;
+    if( engine == ENGINE_SIMD || engine == ENGINE_SIMD16 )
+        x = ScaleImage_Invoker_simd( factor, winSize, sum_col, step, x2, y_bias);
+    else if( engine == ENGINE_STAGE_MAJOR )
+        x = ScaleImage_Invoker_stagemajor( factor, winSize, sum_col, step, x2, y_bias);
+
+    /* the normalization of the remaining windows first, for the row */
+    n = varianceNorms( x, x2, step, sum_col, survivor_norm.data());
+
+    for( k = 0; k < n; k++, x += step )
+    {
+        /* below the variance floor */
+        if( survivor_norm[k] == 0 )
+            continue;
+        p.x = x;
+
+        result = runCascadeClassifier( p, 0, sum_col, survivor_norm[k]);
+
+        if( result > 0 )
+            recordFace( x, y_bias, factor, winSize);
+    }
+}
+
+/* the buffers and tables the SIMD kernels read */
+void facedetect_worker::setCascadeView( CascadeView* view, int sum_col)
+{
+    view->sum = sum_window;
+    view->sqsum = sqsum_window;
+    view->rect_offsets = scaled_rectangles_array;
+#ifdef PACKED_CLASSIFIERS
+    view->classifiers = classifiers;
+#endif
+    view->weights = layout->weights;
+    view->tree_thresh = layout->tree_thresh;
+    view->alpha1 = layout->alpha1;
+    view->alpha2 = layout->alpha2;
+    view->stages = layout->stage_features;
+    view->two_rect = layout->stage_two_rect;
+    view->corner_offsets = corner_offsets;
+    view->stage_corners = layout->stage_corners;
+    view->rect_corners = layout->rect_corner;
+    view->stage_limit = layout->stage_limit;
+    view->nstages = layout->nstages;
+    view->width = sum_col;
+    view->win_width = cascadeObj.orig_window_size.width;
+    view->win_height = cascadeObj.orig_window_size.height;
+    view->inv_window_area = cascadeObj.inv_window_area;
+    view->var_floor = var_floor;
+}
+
+/*******************************************************
+ * ScaleImage_Invoker with the SIMD engine:
+ * the windows at x, x+step, ... go through the cascade
+ * together (cascade_simd.cpp), after the normalization
+ * of all the blocks of the row. Returns the first x
+ * that is not covered by a whole block.
+ ******************************************************/
+int facedetect_worker::ScaleImage_Invoker_simd( fx_wide_factor_t factor, MySize winSize, int sum_col, int shift_step, int x2, int y_bias)
+{
+    int lanes = cascadeSimdLanes(engine == ENGINE_SIMD16);
+    int x, k, n, passed;
+    CascadeView view;
+
+    if( lanes == 0 )
+        return 0;
+
+    setCascadeView( &view, sum_col);
+
+    /* whole blocks of the row */
+    n = (x2 > 0) ? (x2 - 1)/shift_step + 1 : 0;
+    n = n/lanes*lanes;
+    varianceNormSimd( &view, lanes, 0, shift_step, n, survivor_norm.data());
+    countSkipped( survivor_norm.data(), n);
+
+    for( x = 0; x + (lanes-1)*shift_step <= x2-1; x += lanes*shift_step )
+    {
+        passed = runCascadeSimd( &view, lanes, x, shift_step, &survivor_norm[x/shift_step]);
+        for( k = 0; k < lanes; k++ )
+        {
+            if( passed & (1 << k) )
+                recordFace( x + k*shift_step, y_bias, factor, winSize);
+        }
+    }
+    return x;
+}
+
+/*******************************************************
+ * ScaleImage_Invoker with the stage-major engine:
+ * stage 0 is evaluated for every window of the row,
+ * the windows that pass are compacted into a survivor
+ * list (in x order), then stage 1 runs on the survivors,
+ * and so on. The features of one stage stay in cache
+ * while they are applied to all windows, and the many
+ * windows rejected by the first stages cost one pass.
+ * When the CPU has AVX2 the survivor list is evaluated
+ * 8 windows at a time with gathers.
+ ******************************************************/
+int facedetect_worker::ScaleImage_Invoker_stagemajor( fx_wide_factor_t factor, MySize winSize, int sum_col, int shift_step, int x2, int y_bias)
+{
+    int lanes = cascadeSimdLanes(0);
+    int i, k, n, first, nfeatures, ntwo, survivors;
+    int haar_counter = 0;
+    int x;
+    CascadeView view;
+
+    setCascadeView( &view, sum_col);
+
+    /* all windows of the row, but the ones below the variance floor */
+    n = varianceNorms( 0, x2, shift_step, sum_col, survivor_norm.data());
+    survivors = 0;
+    for( k = 0, x = 0; k < n; k++, x += shift_step )
+    {
+        if( survivor_norm[k] == 0 )
+            continue;
+        survivor_x[survivors] = x;
+        survivor_norm[survivors] = survivor_norm[k];
+        survivors++;
+    }
+    n = survivors;
+
+    for( i = 0; i < layout->nstages && n > 0; i++ )
+    {
+        /* same 200-feature cap and feature indexing as runCascadeClassifier */
+        nfeatures = layout->stage_features[i];
+        ntwo = layout->stage_two_rect[i];
+
+        first = 0;
+        if( lanes > 0 )
+            first = runStageSimd( &view, lanes, i, haar_counter, survivor_x.data(), survivor_norm.data(), survivor_sum.data(), n);
+
+        for( k = first; k < n; k++ )
+            survivor_sum[k] = 0;
+
+        stageFeatures<2>( haar_counter, haar_counter + ntwo, first, n);
+        stageFeatures<3>( haar_counter + ntwo, haar_counter + nfeatures, first, n);
+        haar_counter += nfeatures;
+
+        /* keep the windows passing the stage, in the same order */
+        survivors = 0;
+        for( k = 0; k < n; k++ )
+        {
+            if( survivor_sum[k] >= layout->stage_limit[i] )
+            {
+                survivor_x[survivors] = survivor_x[k];
+                survivor_norm[survivors] = survivor_norm[k];
+                survivors++;
+            }
+        }
+        n = survivors;
+    }
+
+    for( k = 0; k < n; k++ )
+        recordFace( survivor_x[k], y_bias, factor, winSize);
+
+    return x;
+}
+
+/* features j_begin to j_end-1, all with NRECTS rectangles, for survivors first to n-1 */
+template<int NRECTS>
+void facedetect_worker::stageFeatures( int j_begin, int j_end, int first, int n)
+{
+    int j, k;
+
+    for( j = j_begin; j < j_end && first < n; j++ )
+    {
+#ifdef PACKED_CLASSIFIERS
+        const rect_offset_t* r = classifiers[j].offsets;
+        int thresh = classifiers[j].tree_thresh;
+        int alpha1 = classifiers[j].alpha1;
+        int alpha2 = classifiers[j].alpha2;
+        int weight0 = classifiers[j].weights[0];
+        int weight1 = classifiers[j].weights[1];
+        int weight2 = classifiers[j].weights[2];
+#else
+        const rect_offset_t* r = scaled_rectangles_array + 12*j;
+        int thresh = layout->tree_thresh[j];
+        int alpha1 = layout->alpha1[j];
+        int alpha2 = layout->alpha2[j];
+        int weight0 = layout->weights[3*j];
+        int weight1 = layout->weights[3*j + 1];
+        int weight2 = layout->weights[3*j + 2];
+#endif
+
+        for( k = first; k < n; k++ )
+        {
+            const int* p = sum_window + survivor_x[k];
+            int t = thresh * survivor_norm[k];
+            int sum = (p[r[0]] - p[r[1]] - p[r[2]] + p[r[3]]) * weight0
+                    + (p[r[4]] - p[r[5]] - p[r[6]] + p[r[7]]) * weight1;
+            if( NRECTS == 3 )
+                sum += (p[r[8]] - p[r[9]] - p[r[10]] + p[r[11]]) * weight2;
+            int pass = -(sum >= t);
+            survivor_sum[k] += (alpha2 & pass) | (alpha1 & ~pass);
+        }
+    }
+}
+
+void facedetect_worker::recordFace( int x, int y_bias, fx_wide_factor_t factor, MySize winSize)
+{
+    MyRect r = { myRound((x + scan_x_offset)*factor), myRound(y_bias*factor), winSize.width, winSize.height };
+    face_list->push_back(r);
+}
+
+/*******************************************************
+ * Function: detectBandScaled
+ * Description: the windows of a band of one level in
+ * the feature-scaling mode. The windows are the ones of
+ * the pyramid mode, at (x, y_bias) on the level grid,
+ * read at (myRound(x*factor), myRound(y_bias*factor))
+ * in the frame, where the faces are reported, with the
+ * features scaled to the window size. Windows reaching
+ * past the frame by the rounding are skipped. Returns
+ * the number of windows.
+ ******************************************************/
+template<typename SUM_T, typename SQSUM_T>
+long facedetect_worker::detectBandScaled( const SUM_T* sum, const SQSUM_T* sqsum, const PyramidLevel& level, const DetectTask& task, int shift_step, std::vector<MyRect>& faces)
+{
+    int x, y, fx, fy;
+    int x_begin = (task.x_begin + shift_step-1)/shift_step*shift_step;
+    int x_end = (task.x_end < level.sz.width-24) ? task.x_end : level.sz.width-24;
+    int extent = level.winSize.width;
+    long windows = 0;
+
+    variance_skipped = 0;
+    if( level.factor.to_double() != scaled_factor || frame_width != scaled_width )
+        scaleFeatures( level.factor);
+
+    for( y = task.y_begin; y < task.y_end; y++ )
+    {
+        fy = myRound(y*level.factor);
+        if( fy + extent >= frame_height )
+            break;
+        for( x = x_begin; x < x_end; x += shift_step )
+        {
+            fx = myRound(x*level.factor);
+            if( fx + extent >= frame_width )
+                break;
+            windows++;
+            if( runScaledCascade( sum, sqsum, fy*frame_width + fx) > 0 )
+            {
+                MyRect r = { fx, fy, level.winSize.width, level.winSize.height };
+                faces.push_back(r);
+            }
+        }
+    }
+    return windows;
+}
+
+/*******************************************************
+ * The rectangles of the layout scaled by the factor of
+ * a level: each corner is rounded, so the rectangles of
+ * a feature keep touching each other. The weights are
+ * divided by the change of area of their rectangle and
+ * the weight of the first rectangle absorbs the rounding
+ * of the others, so the weighted areas of a feature add
+ * up to the same value as in the 24 x 24 window (0 for
+ * the usual cascades, a flat window gives no response).
+ * With the weights times 65536, the feature sums come
+ * out in the units of the 24 x 24 window, and at factor
+ * 1 they are exactly the ones of the pyramid mode.
+ ******************************************************/
+void facedetect_worker::scaleFeatures( fx_wide_factor_t factor)
+{
+    int j, k, nrects, x0, y0, x1, y1;
+    int area, scaled_area[3];
+    int64_t balance, rest;
+    int v = myRound((cascadeObj.orig_window_size.width - 1)*factor);
+
+    scaled_offsets.resize(12*layout->count);
+    scaled_weights.resize(3*layout->count);
+    cascadeObj.inv_window_area = cascadeObj.orig_window_size.width*cascadeObj.orig_window_size.height;
+
+    /* the variance window of updatePvalue, 23 x 23 pixels at factor 1 */
+    scaled_var_offsets[0] = 0;
+    scaled_var_offsets[1] = v;
+    scaled_var_offsets[2] = frame_width*v;
+    scaled_var_offsets[3] = frame_width*v + v;
+    scaled_var_ratio = ((uint64_t)(cascadeObj.orig_window_size.width - 1)*(cascadeObj.orig_window_size.height - 1) << 32)/(v*v);
+
+    for( j = 0; j < layout->count; j++ )
+    {
+        const int* rect = &layout->rectangles[12*j];
+        const int* w = &layout->weights[3*j];
+        int* offsets = &scaled_offsets[12*j];
+        int64_t* weights = &scaled_weights[3*j];
+
+        nrects = CascadeLayout::hasThirdRect(rect) ? 3 : 2;
+        balance = 0;
+        rest = 0;
+        for( k = 0; k < 12; k++ )
+            offsets[k] = 0;
+        for( k = 0; k < 3; k++ )
+            weights[k] = 0;
+
+        for( k = 0; k < nrects; k++ )
+        {
+            x0 = myRound(rect[4*k]*factor);
+            y0 = myRound(rect[4*k + 1]*factor);
+            x1 = myRound((rect[4*k] + rect[4*k + 2])*factor);
+            y1 = myRound((rect[4*k + 1] + rect[4*k + 3])*factor);
+            offsets[4*k] = frame_width*y0 + x0;
+            offsets[4*k + 1] = frame_width*y0 + x1;
+            offsets[4*k + 2] = frame_width*y1 + x0;
+            offsets[4*k + 3] = frame_width*y1 + x1;
+
+            area = rect[4*k + 2]*rect[4*k + 3];
+            scaled_area[k] = (x1 - x0)*(y1 - y0);
+            balance += (int64_t)w[k]*area*65536;
+            if( k > 0 && scaled_area[k] > 0 )
+            {
+                weights[k] = roundDiv((int64_t)w[k]*area*65536, scaled_area[k]);
+                rest += weights[k]*scaled_area[k];
+            }
+        }
+        if( scaled_area[0] > 0 )
+            weights[0] = roundDiv(balance - rest, scaled_area[0]);
+    }
+
+    scaled_factor = factor.to_double();
+    scaled_width = frame_width;
+}
+
+/*******************************************************
+ * runCascadeClassifier for one window of the frame
+ * integral images. The sum and squared sum of the
+ * variance window are brought back to its 23 x 23
+ * pixels before the variance_norm_factor formula of
+ * varianceNormFactor, 32-bit wrap-around included, and
+ * the feature sums are in the units of the 24 x 24
+ * window (scaleFeatures), so the node thresholds, the
+ * alphas and stage_limit are used as they are.
+ ******************************************************/
+template<typename SUM_T, typename SQSUM_T>
+int facedetect_worker::runScaledCascade( const SUM_T* sum, const SQSUM_T* sqsum, int p_offset)
+{
+    int i, j, t, stage_sum;
+    int feature = 0;
+    unsigned int mean;
+    unsigned int variance_norm_factor;
+    int64_t feature_sum;
+    const SUM_T* p = sum + p_offset;
+    const SQSUM_T* pq = sqsum + p_offset;
+    const int* v = scaled_var_offsets;
+
+    /* on the pixels of the scaled variance window */
+    if( var_floor > 0 && belowVarianceFloor( p[v[0]] - p[v[1]] - p[v[2]] + p[v[3]], pq[v[0]] - pq[v[1]] - pq[v[2]] + pq[v[3]], (int64_t)v[1]*v[1]) )
+    {
+        variance_skipped++;
+        return 0;
+    }
+
+    mean = (unsigned int)(((p[v[0]] - p[v[1]] - p[v[2]] + p[v[3]])*scaled_var_ratio + 0x80000000u) >> 32);
+    variance_norm_factor = (unsigned int)(((pq[v[0]] - pq[v[1]] - pq[v[2]] + pq[v[3]])*scaled_var_ratio + 0x80000000u) >> 32);
+
+    variance_norm_factor = (variance_norm_factor*cascadeObj.inv_window_area);
+    variance_norm_factor =  variance_norm_factor - mean*mean;
+
+    if( variance_norm_factor > 0 )
+        variance_norm_factor = int_sqrt(variance_norm_factor);
+    else
+        variance_norm_factor = 1;
+
+    for( i = 0; i < layout->nstages; i++ )
+    {
+        stage_sum = 0;
+        for( j = 0; j < layout->stage_features[i]; j++, feature++ )
+        {
+            const int* r = &scaled_offsets[12*feature];
+            const int64_t* w = &scaled_weights[3*feature];
+
+            feature_sum = (int64_t)(p[r[0]] - p[r[1]] - p[r[2]] + p[r[3]]) * w[0]
+                        + (int64_t)(p[r[4]] - p[r[5]] - p[r[6]] + p[r[7]]) * w[1];
+            if( j >= layout->stage_two_rect[i] )
+                feature_sum += (int64_t)(p[r[8]] - p[r[9]] - p[r[10]] + p[r[11]]) * w[2];
+
+            /* back to the 32-bit sum of evalWeakClassifier */
+            t = layout->tree_thresh[feature] * variance_norm_factor;
+            stage_sum += ((int)(feature_sum >> 16) >= t) ? layout->alpha2[feature] : layout->alpha1[feature];
+        }
+
+        if( stage_sum < layout->stage_limit[i] )
+            return -i;
+    }
+    return 1;
+}
+
+/*****************************************************
+ * Compute the integral image (and squared integral)
+ * Integral image helps quickly sum up an area.
+ * More info:
+ * http://en.wikipedia.org/wiki/Summed_area_table
+ ****************************************************/
+void facedetect_worker::integralImages( int row_begin, int *sumData, int *sqsumData, int width, int height)
+{
+    int x, y, s, sq, t, tq;
+    unsigned char it;
+    const unsigned char* src;
+
+    if( simd_integral )
+    {
+        for( y = 0; y < height; y++)
+            integralRowSimd(levelRow(row_begin + y, width), (y != 0) ? sumData + (y-1)*width : NULL, (y != 0) ? sqsumData + (y-1)*width : NULL,
+                            sumData + y*width, sqsumData + y*width, NULL, NULL, width);
+        return;
+    }
+
+    for( y = 0; y < height; y++)
+    {
+        src = levelRow(row_begin + y, width);
+        s = 0;
+        sq = 0;
+        /* loop over the number of columns */
+        for( x = 0; x < width; x ++)
+        {
+            it = src[x];
+            /* sum of the current row (integer)*/
+            s += it;
+            sq += it*it;
+
+            t = s;
+            tq = sq;
+            if (y != 0)
+            {
+                t += sumData[(y-1)*width+x];
+                tq += sqsumData[(y-1)*width+x];
+            }
+            sumData[y*width+x]=t;
+            sqsumData[y*width+x]=tq;
+        }
+    }
+}
+
+/*********************************************************
+ * Move the integral image window down by one row.
+ * The buffers hold 2 x 25 rows: image row r of the band
+ * is kept at buffer row r%25 and again at r%25+25, so the
+ * 25 rows of the window, starting at window_row, are
+ * always contiguous and the rectangle offsets of
+ * setImageForCascadeClassifier apply unchanged. Only the
+ * new row is computed and written twice, instead of
+ * shifting 24 rows up.
+ ********************************************************/
+void facedetect_worker::integralmages_lastrow( int *sumData, int *sqsumData, int width, int y_bias)
+{
+    int x, s, sq, t, tq;
+    unsigned char it;
+    const unsigned char* src = levelRow(24+y_bias, width);
+    int* sum_prev = sumData + (window_row+24)*width;
+    int* sqsum_prev = sqsumData + (window_row+24)*width;
+    /* the row leaving the window is replaced by the new one */
+    int* sum_new = sumData + window_row*width;
+    int* sqsum_new = sqsumData + window_row*width;
+
+    if( simd_integral )
+    {
+        integralRowSimd(src, sum_prev, sqsum_prev, sum_new, sqsum_new, sum_new + 25*width, sqsum_new + 25*width, width);
+        window_row = (window_row == 24) ? 0 : window_row+1;
+        return;
+    }
+
+    s = 0;
+    sq = 0;
+    for(x=0; x<width; x++){
+        it = src[x];
+        s += it;
+        sq += it*it;
+
+        t = s + sum_prev[x];
+        tq = sq + sqsum_prev[x];
+
+        sum_new[x] = t;
+        sqsum_new[x] = tq;
+        sum_new[25*width+x] = t;
+        sqsum_new[25*width+x] = tq;
+    }
+
+    window_row = (window_row == 24) ? 0 : window_row+1;
+}
+
+/***********************************************************
+ * Nearest neighbor down-sampling of the frame to a level of
+ * the image pyramid, as index tables: level pixel (j, i) is
+ * frame pixel (x_index[j], y_index[i]). The tables replace
+ * a down-sampled copy of the level, each integral image row
+ * samples its frame row through them (levelRow).
+ **********************************************************/
+void facedetect_worker::scaleIndexTables( int width, int height)
+{
+    int i;
+    int j;
+    int w1 = frame_width;
+    int h1 = frame_height;
+    int w2 = width;
+    int h2 = height;
+
+    int rat = 0;
+    int x_ratio = (int)((w1<<16)/w2) +1;
+    int y_ratio = (int)((h1<<16)/h2) +1;
+
+    for(j=0;j<w2;j++)
+    {
+        x_index[j] = (rat>>16);
+        rat += x_ratio;
+    }
+    for (i=0;i<h2;i++)
+        y_index[i] = ((i*y_ratio)>>16);
+}
+
+/* the level row stays in row_buffer, in the cache, until the integral image row has read it */
+const unsigned char* facedetect_worker::levelRow( int row, int cols)
+{
+    int x;
+    const unsigned char* src;
+    const int* x_idx = &x_index[scan_x_offset];
+
+    if( level_src != NULL )
+        return level_src + row*frame_width + scan_x_offset;
+
+    src = in_img_buffer + y_index[row]*frame_width;
+    for( x = 0; x < cols; x++ )
+        row_buffer[x] = src[x_idx[x]];
+    return row_buffer.data();
+}
+
+/***********************************************************
+ * This function downsample an image using nearest neighbor
+ * It is used to build the image pyramid ahead of the
+ * cascade (facedetect_stream)
+ **********************************************************/
+void facedetect_worker::nearestNeighbor ( unsigned char* dst, int width, int height, int row_begin, int row_end)
+{
+    int i;
+    int j;
+    int w1 = frame_width;
+    const uint8_t* src;
+
+    scaleIndexTables( width, height);
+
+    /* only rows row_begin to row_end-1 of the down-sampled image */
+    for (i=row_begin;i<row_end;i++)
+    {
+        src = in_img_buffer + y_index[i]*w1;
+        for(j=0;j<width;j++)
+            dst[i*w1+j] = src[x_index[j]];
+    }
+}
+
+void facedetect_host::groupRectangles( int groupThreshold, fx_scale_t eps)
+{
+    if( groupThreshold <= 0 || face_number==0 )
+        return;
+
+    std::vector<int> labels(face_number);
+
+    int nclasses = partition(labels.data(), eps);
+    
+    /* MAXLABELS classes are enough for a 360x240 frame, a larger frame can have a class per candidate */
+    std::vector<MyRect> rrects(nclasses);
+    std::vector<int> rweights(nclasses);
+    
+    int i, j, nlabels = face_number;
+
+    for( i = 0; i < nclasses; i++ )
+    {
+        rrects[i].x = 0;
+        rrects[i].y = 0;
+        rrects[i].width = 0;
+        rrects[i].height = 0;
+        rweights[i]=0;
+    }
+    
+    for( i = 0; i < nlabels; i++ )
+    {
+        int cls = labels[i];
+        rrects[cls].x += face_coordinate[i].x;
+        rrects[cls].y += face_coordinate[i].y;
+        rrects[cls].width += face_coordinate[i].width;
+        rrects[cls].height += face_coordinate[i].height;
+        rweights[cls]++;
+    }
+    
+    for( i = 0; i < nclasses; i++ )
+    {
+        MyRect r = rrects[i];
+        if( rweights[i] < MAX_NUM_FACE )
+        {
+            fx_recip_t s = 1.0/rweights[i];
+            rrects[i].x = myRound(r.x*s);
+            rrects[i].y = myRound(r.y*s);
+            rrects[i].width = myRound(r.width*s);
+            rrects[i].height = myRound(r.height*s);
+        }
+        else
+        {
+            /* a class the facedetect module cannot have, 1/weight would round to a few steps of fx_recip_t */
+            fx_wide_recip_t s = 1.0/rweights[i];
+            rrects[i].x = myRound(r.x*s);
+            rrects[i].y = myRound(r.y*s);
+            rrects[i].width = myRound(r.width*s);
+            rrects[i].height = myRound(r.height*s);
+        }
+    }
+
+    face_number=0;
+
+    for( i = 0; i < nclasses; i++ )
+    {
+        MyRect r1 = rrects[i];
+        int n1 = rweights[i];
+        if( n1 <= groupThreshold )
+            continue;
+        /* filter out small face rectangles inside large rectangles */
+        for( j = 0; j < nclasses; j++ )
+        {
+            int n2 = rweights[j];
+            /*********************************
+            * if it is the same rectangle, 
+            * or the number of rectangles in class j is < group threshold, 
+            * do nothing 
+            ********************************/
+            if( j == i || n2 <= groupThreshold )
+                continue;
+            
+            MyRect r2 = rrects[j];
+
+            int dx = myRound( r2.width * eps );
+            int dy = myRound( r2.height * eps );
+
+            if( i != j &&
+                r1.x >= r2.x - dx &&
+                r1.y >= r2.y - dy &&
+                r1.x + r1.width <= r2.x + r2.width + dx &&
+                r1.y + r1.height <= r2.y + r2.height + dy &&
+                (n2 > ( (3>n1) ? 3 : n1 ) || n1 < 3) )
+                break;
+        }
+
+        /* the classes are fewer than the candidates, face_number stays behind i */
+        if( j == nclasses )
+            face_coordinate[face_number++] = r1;
+    }
+    face_coordinate.resize(face_number);
+}
+
+int facedetect_host::partition(int* labels, fx_scale_t eps)
+{
+    int i, j;
+    int N = face_number;
+
+    const int _PArent=0;
+    const int _RAnk=1;
+
+    std::vector< std::array<int,2> > nodes(N);
+    
+    /* The first O(N) pass: create N single-vertex trees */
+    for(i = 0; i < N; i++)
+    {
+        nodes[i][_PArent]=-1;
+        nodes[i][_RAnk] = 0;
+    }
+
+    /* The main O(N^2) pass: merge connected components */
+    for( i = 0; i < N; i++ )
+    {
+        int root = i;
+
+        /* find root */
+        while( nodes[root][_PArent] >= 0 )
+        root = nodes[root][_PArent];
+
+        for( j = 0; j < N; j++ )
+        {
+            if( i == j || !predicate(eps, face_coordinate[i], face_coordinate[j]))
+                continue;
+            int root2 = j;
+
+            while( nodes[root2][_PArent] >= 0 )
+            root2 = nodes[root2][_PArent];
+
+            if( root2 != root )
+            {
+                /* unite both trees */
+                int rank = nodes[root][_RAnk], rank2 = nodes[root2][_RAnk];
+                if( rank > rank2 )
+                    nodes[root2][_PArent] = root;
+                else
+                {
+                    nodes[root][_PArent] = root2;
+                    nodes[root2][_RAnk] += rank == rank2;
+                    root = root2;
+                }
+
+                int k = j, parent;
+
+                /* compress the path from node2 to root */
+                while( (parent = nodes[k][_PArent]) >= 0 )
+                {
+                    nodes[k][_PArent] = root;
+                    k = parent;
+                }
+
+                /* compress the path from node to root */
+                k = i;
+                while( (parent = nodes[k][_PArent]) >= 0 )
+                {
+                    nodes[k][_PArent] = root;
+                    k = parent;
+                }
+            }
+        }
+    }
+
+    int nclasses = 0;
+
+    for( i = 0; i < N; i++ )
+    {
+        int root = i;
+        while( nodes[root][_PArent] >= 0 )
+            root = nodes[root][_PArent];
+        /* re-use the rank as the class label */
+        if( nodes[root][_RAnk] >= 0 )
+            nodes[root][_RAnk] = ~nclasses++;
+        labels[i] = ~nodes[root][_RAnk];
+    }
+
+    return nclasses;
+}
+
+
+int facedetect_host::predicate(fx_scale_t eps, const MyRect& r1, const MyRect& r2)
+{
+    fx_wide_delta_t delta = (fx_wide_delta_t)0.5*eps*(((r1.width>r2.width) ? r2.width : r1.width) + ((r1.height>r2.height) ? r2.height : r1.height));
+    return myAbs(r1.x - r2.x) <= delta &&
+        myAbs(r1.y - r2.y) <= delta &&
+        myAbs(r1.x + r1.width - r2.x - r2.width) <= delta &&
+        myAbs(r1.y + r1.height - r2.y - r2.height) <= delta;
+}
+
+void setDefaultParams(DetectParams* params)
+{
+    params->scaleFactor = 1.2;
+    params->shiftStep = 1;
+    params->minNeighbours = 1;
+    params->minSize.height = 20;
+    params->minSize.width = 20;
+    params->engine = ENGINE_SCALAR;
+    params->scanMode = SCAN_PYRAMID;
+    params->threads = 1;
+    params->bandRows = 0;
+    params->trackInterval = 0;
+    params->sceneChange = 12;
+    params->varianceFloor = 0;
+    params->cascade = NULL;
+    params->layout = NULL;
+    params->roi = NULL;
+    params->roiCount = 0;
+    params->roiMask = NULL;
+    params->coarseStep = 0;
+    params->refineStage = 3;
+}
+
+facedetect_worker::facedetect_worker()
+{
+    cascadeObj.orig_window_size.height = 24;  //original window height
+    cascadeObj.orig_window_size.width = 24;   //original window width
+    in_img_buffer = NULL;
+    level_src = NULL;
+    row_buffer.resize(MAX_WINDOW_COLS);
+    face_list = NULL;
+    scan_x_offset = 0;
+    engine = ENGINE_SCALAR;
+    frame_width = 0;
+    frame_height = 0;
+    scaled_rectangles_array = NULL;
+    corner_offsets = NULL;
+#ifdef PACKED_CLASSIFIERS
+    classifiers = NULL;
+#endif
+    rect_uses = 0;
+    rect_tables.reserve(RECT_CACHE_SIZE);
+    window_row = 0;
+    sum_window = NULL;
+    sqsum_window = NULL;
+    layout = NULL;
+    scaled_factor = -1;
+    scaled_width = 0;
+#ifdef NO_SIMD_INTEGRAL
+    simd_integral = false;
+#else
+    simd_integral = integralSimdAvailable() != 0;
+#endif
+#ifdef NO_SIMD_NORM
+    norm_lanes = 0;
+#else
+    norm_lanes = cascadeSimdLanes(1);
+#endif
+    var_floor = 0;
+    variance_skipped = 0;
+    coarse_step = 0;
+    refine_stage = 0;
+}
+
+/* the rectangle offset tables belong to the layout, another cascade starts with an empty cache */
+void facedetect_worker::setCascade( const CascadeLayout* cascade_layout)
+{
+    if( cascade_layout == layout )
+        return;
+    layout = cascade_layout;
+    rect_tables.clear();
+    rect_uses = 0;
+    scaled_factor = -1;
+    scaled_rectangles_array = NULL;
+    corner_offsets = NULL;
+#ifdef PACKED_CLASSIFIERS
+    classifiers = NULL;
+#endif
+}
+
+void facedetect_worker::setVarianceFloor( int floor)
+{
+    var_floor = floor;
+}
+
+void facedetect_worker::setAdaptiveScan( int coarse, int stage)
+{
+    coarse_step = coarse;
+    refine_stage = stage;
+}
+
+long facedetect_worker::varianceSkipped(void) const
+{
+    return variance_skipped;
+}
+
+/* the buffers grow with the frame, a smaller frame keeps them */
+void facedetect_worker::setFrameSize( int width, int height)
+{
+    frame_width = width;
+    frame_height = height;
+    if( (int)x_index.size() < width )
+        x_index.resize(width);
+    if( (int)y_index.size() < height )
+        y_index.resize(height);
+    if( (int)int_img_buffer.size() < 2*25*width )
+    {
+        int_img_buffer.resize(2*25*width);
+        sq_int_buffer.resize(2*25*width);
+        survivor_x.resize(width);
+        survivor_norm.resize(width);
+        survivor_sum.resize(width);
+    }
+}
+
+facedetect_host::facedetect_host()
+{
+    cascadeObj.orig_window_size.height = 24;  //original window height
+    cascadeObj.orig_window_size.width = 24;   //original window width
+    in_img_buffer = NULL;
+    pyramid_images = NULL;
+    pyramid_rows = 0;
+    face_number = 0;
+    engine = ENGINE_SCALAR;
+    scanMode = SCAN_PYRAMID;
+    threads = 1;
+    bandRows = 0;
+    band_target = 0;
+    trackInterval = 0;
+    sceneChange = 0;
+    frame_width = 0;
+    frame_height = 0;
+    tracking_scan = false;
+    frames_since_full = 0;
+    tracking_stats.full_scans = 0;
+    tracking_stats.tracking_scans = 0;
+    tracking_stats.scene_changes = 0;
+    scan_stats.frames = 0;
+    scan_stats.windows = 0;
+    scan_stats.skipped = 0;
+    varianceFloor = 0;
+    coarseStep = 0;
+    refineStage = 0;
+    cascade = NULL;
+    own_layout = NULL;
+    layout = NULL;
+}
+
+facedetect_host::~facedetect_host()
+{
+    int t;
+
+    for( t = 0; t < (int)workers.size(); t++ )
+        delete workers[t];
+    delete own_layout;
+}
+
+/*******************************************************
+ * Function: detect
+ * Description: host replacement of detection_main,
+ * the frame and the parameters are passed directly
+ * instead of through the input ports
+ ******************************************************/
+int facedetect_host::detect(const uint8_t* img, int width, int height, const DetectParams& params, std::vector<MyRect>& faces)
+{
+    faces.clear();
+    if( setParams(width, height, params) < 0 )
+        return -1;
+
+    in_img_buffer = img;
+    pyramid_images = NULL;
+
+    /* temporal-coherence mode: rescan around the faces of the previous frame */
+    tracking_scan = false;
+    if( trackInterval > 0 )
+        tracking_scan = !needFullScan(img);
+
+    detectObjects(minSize, scaleFactor, minNeighbours, shiftStep);
+
+    faces.insert( faces.end(), face_coordinate.begin(), face_coordinate.end());
+    in_img_buffer = NULL;
+    if( trackInterval > 0 )
+        prev_faces = faces;
+
+    return face_number;
+}
+
+void facedetect_host::resetTracking(void)
+{
+    prev_faces.clear();
+    prev_sample.clear();
+    frames_since_full = 0;
+}
+
+void facedetect_host::getTrackingStats( TrackingStats* stats) const
+{
+    *stats = tracking_stats;
+}
+
+int facedetect_host::setParams(int width, int height, const DetectParams& params)
+{
+    int i;
+    fx_wide_factor_t first_factor;
+
+    if( width < 24 || height < 24 || width > MAX_FRAME_SIZE || height > MAX_FRAME_SIZE )
+    {
+        printf("ERROR: image size %d x %d is not supported, from 24 x 24 to %d x %d\n", width, height, MAX_FRAME_SIZE, MAX_FRAME_SIZE);
+        return -1;
+    }
+    /* the pyramid ends only when the levels shrink, so the first step of buildPyramid has to grow the factor */
+    first_factor = 1;
+    if( params.scaleFactor > 1 )
+        first_factor *= (fx_scale_t)params.scaleFactor;
+    if( !(1 < first_factor) )
+    {
+        printf("ERROR: scale factor %f, it has to be at least 1.012\n", params.scaleFactor);
+        return -1;
+    }
+    if( params.shiftStep < 1 )
+    {
+        printf("ERROR: shift step %d, it has to be at least 1\n", params.shiftStep);
+        return -1;
+    }
+    if( params.scanMode == SCAN_FEATURES && params.engine != ENGINE_SCALAR )
+    {
+        printf("ERROR: engine %d, the feature-scaling scan only runs the scalar engine\n", params.engine);
+        return -1;
+    }
+    /* the column tiles of detectBand have to hold the coarse windows and the margins of stride-1 windows on both sides */
+    if( params.coarseStep > 1 &&
+        (MAX_WINDOW_COLS - 24 - 2*((int64_t)params.coarseStep-1)*params.shiftStep)/params.shiftStep*params.shiftStep <= 0 )
+    {
+        printf("ERROR: coarse stride %d, it has to be at most %d with shift step %d\n", params.coarseStep,
+               (MAX_WINDOW_COLS - 24 - params.shiftStep)/(2*params.shiftStep) + 1, params.shiftStep);
+        return -1;
+    }
+
+    /* the layout of params.cascade is built once, when the pointer changes */
+    if( params.layout != NULL )
+        layout = params.layout;
+    else if( params.cascade == NULL )
+        layout = builtinLayout();
+    else
+    {
+        if( params.cascade != cascade || own_layout == NULL )
+        {
+            if( checkCascade(*params.cascade) < 0 )
+                return -1;
+            delete own_layout;
+            own_layout = buildCascadeLayout(*params.cascade);
+            cascade = params.cascade;
+        }
+        layout = own_layout;
+    }
+
+    scaleFactor = params.scaleFactor;
+    shiftStep = params.shiftStep;
+    minNeighbours = params.minNeighbours;
+    minSize = params.minSize;
+    engine = params.engine;
+    scanMode = params.scanMode;
+    varianceFloor = params.varianceFloor;
+    coarseStep = params.coarseStep;
+    refineStage = params.refineStage;
+    threads = params.threads;
+    bandRows = params.bandRows;
+    if( params.trackInterval != trackInterval || width != frame_width || height != frame_height )
+        resetTracking();
+    frame_width = width;
+    frame_height = height;
+    trackInterval = params.trackInterval;
+    sceneChange = params.sceneChange;
+
+    /* the regions of interest, clipped to the frame */
+    roi_rects.clear();
+    if( params.roiMask != NULL )
+        maskRegions( params.roiMask, width, height, roi_rects);
+    else if( params.roi != NULL )
+    {
+        for( i = 0; i < params.roiCount; i++ )
+        {
+            MyRect r = params.roi[i];
+            int x_end = (r.x + r.width < width) ? r.x + r.width : width;
+            int y_end = (r.y + r.height < height) ? r.y + r.height : height;
+            r.x = (r.x > 0) ? r.x : 0;
+            r.y = (r.y > 0) ? r.y : 0;
+            r.width = x_end - r.x;
+            r.height = y_end - r.y;
+            if( r.width > 0 && r.height > 0 )
+                roi_rects.push_back(r);
+        }
+    }
+    /* no region inside the frame: nothing to scan, not the whole frame */
+    if( (params.roiMask != NULL || params.roi != NULL) && roi_rects.empty() )
+    {
+        MyRect none = { 0, 0, 0, 0 };
+        roi_rects.push_back(none);
+    }
+
+    buildPyramid(minSize, scaleFactor);
+    return 0;
+}
+
+/* the feature-scaling mode only needs the frame */
+int facedetect_host::pyramidRows(void) const
+{
+    if( scanMode == SCAN_FEATURES )
+        return frame_height;
+    return pyramid_rows;
+}
+
+void facedetect_host::buildPyramidImages(const uint8_t* img, unsigned char* pyramid)
+{
+    int l;
+
+    if( workers.empty() )
+        workers.push_back(new facedetect_worker());
+    workers[0]->setFrameSize( frame_width, frame_height);
+    workers[0]->setCascade( layout);
+
+    if( scanMode == SCAN_FEATURES )
+    {
+        memcpy(pyramid, img, frame_width*frame_height);
+        return;
+    }
+    /* the levels without regions of interest are not read */
+    for( l = 0; l < (int)levels.size(); l++ )
+    {
+        if( !scan_regions[l].empty() )
+            workers[0]->downsample( img, levels[l], pyramid + levels[l].first_row*frame_width);
+    }
+}
+
+int facedetect_host::detectCandidates(unsigned char* pyramid, std::vector<MyRect>& candidates)
+{
+    in_img_buffer = NULL;
+    pyramid_images = pyramid;
+    if( scanMode == SCAN_FEATURES )
+    {
+        in_img_buffer = pyramid;
+        pyramid_images = NULL;
+    }
+
+    findCandidates( shiftStep);
+
+    candidates.assign( face_coordinate.begin(), face_coordinate.end());
+    pyramid_images = NULL;
+    in_img_buffer = NULL;
+
+    return face_number;
+}
+
+int facedetect_host::groupCandidates(const std::vector<MyRect>& candidates, std::vector<MyRect>& faces)
+{
+    /* group overlaping windows */
+    const fx_scale_t GROUP_EPS = 0.4;
+
+    face_coordinate = candidates;
+    face_number = face_coordinate.size();
+
+    if( minNeighbours != 0)
+    {
+        groupRectangles( minNeighbours, GROUP_EPS);
+    }
+
+    faces.clear();
+    faces.insert( faces.end(), face_coordinate.begin(), face_coordinate.end());
+
+    return face_number;
+}
+
+void facedetect_host::getSchedulerStats( SchedulerStats* stats) const
+{
+    scheduler.getStats(stats);
+}
+
+void facedetect_host::getScanStats( ScanStats* stats) const
+{
+    *stats = scan_stats;
+}
+
+int detect(const uint8_t* img, int width, int height, const DetectParams& params, std::vector<MyRect>& faces)
+{
+    facedetect_host* detector = new facedetect_host();
+    int ret_v = detector->detect(img, width, height, params, faces);
+    delete detector;
+    return ret_v;
+}
+
+
+/* End of file. */
@@ -0,0 +1,469 @@
+//============================================================================================
+//
+// File Name    : facedetect_host.h
+// Description  : Host (software) build of the Viola-Jones face detector core
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Detector core as a plain C++ library
+//17/10/2026  1.1       UTD DARClab                  Pyramid levels on parallel workers
+//17/10/2026  1.2       UTD DARClab                  Row bands within a level
+//17/10/2026  1.3       UTD DARClab                  Work-stealing scheduler for the bands
+//17/10/2026  1.4       UTD DARClab                  Temporal-coherence mode for video
+//17/10/2026  1.5       UTD DARClab                  Frames of any size up to MAX_FRAME_SIZE
+//17/10/2026  1.6       UTD DARClab                  Ring buffer for the integral image window
+//17/10/2026  1.7       UTD DARClab                  Cache of the rectangle offsets per window width
+//17/10/2026  1.8       UTD DARClab                  Packed weak-classifier records, window counts
+//17/10/2026  1.9       UTD DARClab                  2-rectangle and 3-rectangle feature kernels
+//17/10/2026  1.10      UTD DARClab                  Corner offsets of each stage
+//17/10/2026  1.11      UTD DARClab                  Row pointers of the compiled cascade
+//17/10/2026  1.12      UTD DARClab                  Cascade of the detection parameters
+//17/10/2026  1.13      UTD DARClab                  Cascade layout of the detection parameters
+//17/10/2026  1.14      UTD DARClab                  SIMD integral image rows
+//17/10/2026  1.15      UTD DARClab                  Down-sampling fused into the integral image
+//17/10/2026  1.16      UTD DARClab                  Feature-scaling scan mode
+//17/10/2026  1.17      UTD DARClab                  Variance normalization of a row of windows
+//17/10/2026  1.18      UTD DARClab                  Variance floor
+//17/10/2026  1.19      UTD DARClab                  Regions of interest
+//17/10/2026  1.20      UTD DARClab                  Coarse-to-fine adaptive scan
+//18/10/2026  1.21      UTD DARClab                  Unused integral pointers dropped from setImageForCascadeClassifier
+//18/10/2026  1.22      UTD DARClab                  Candidates not limited to MAX_NUM_FACE
+//18/10/2026  1.23      UTD DARClab                  Scaled features keyed on the factor value, for the SystemC types
+//18/10/2026  1.24      UTD DARClab                  32-bit frame integrals when the windows allow, scalar engine only for SCAN_FEATURES
+//18/10/2026  1.25      UTD DARClab                  MAX_NUM_FACE candidate limit of the module kept on 360x240 frames
+//============================================================================================
+
+#ifndef FACEDETECT_HOST_H
+#define FACEDETECT_HOST_H
+
+#include "define.h"
+#include "cascade_simd.h"
+#include "task_scheduler.h"
+#include "cascade_layout.h"
+#include <stdint.h>
+
+/* largest frame width or height of the host build, the fx_wide types in define.h cover it */
+#define MAX_FRAME_SIZE 8192
+
+/* widest integral image window, its rectangle offsets (at most 24*width+24) fit a rect_offset_t */
+#define MAX_WINDOW_COLS 2729
+
+/* rectangle offset tables kept by a worker, one per window width */
+#define RECT_CACHE_SIZE 64
+
+/* cascade evaluation engines, all give the same detections */
+enum CascadeEngine
+{
+    ENGINE_SCALAR = 0,  // one window at a time, as in the facedetect module
+    ENGINE_SIMD = 1,    // 8 adjacent windows in the lanes of an AVX2 vector (cascade_simd.cpp)
+    ENGINE_SIMD16 = 2,  // 16 windows with AVX-512, 8 when the CPU only has AVX2
+    ENGINE_STAGE_MAJOR = 3 // one stage for all windows of a row, then the next stage on the survivors
+};
+
+/* how the detection window is scaled */
+enum ScanMode
+{
+    SCAN_PYRAMID = 0,  // the frame down-sampled to each level and its integral images, as in the facedetect module
+    SCAN_FEATURES = 1  // one integral image of the frame, the features scaled to each window size (ENGINE_SCALAR only)
+};
+
+/* detection parameters, the same values the testbench sends to the facedetect module */
+struct DetectParams
+{
+    float scaleFactor;  // scale factor for image down-sampling
+    int shiftStep;      // pixel step for window shifting
+    int minNeighbours;  // group threshold of groupRectangles, 0 disables grouping
+    MySize minSize;     // smallest face size reported
+    int engine;         // CascadeEngine; SCAN_FEATURES has ENGINE_SCALAR only, setParams rejects the others
+    int scanMode;       // ScanMode
+    int threads;        // worker threads for the pyramid levels, 1 runs them in the calling thread
+    int bandRows;       // window rows per task within a level, 0 sizes the bands by their estimated cost
+    int trackInterval;  // video: full scan every trackInterval frames, in between only around the previous faces; 0 scans every frame
+    int sceneChange;    // video: mean grey-level change to the previous frame that forces a full scan
+    int varianceFloor;  // windows with a lower grey-level variance (squared grey levels) are rejected before stage 0; 0: none, as the facedetect module
+    int coarseStep;     // pyramid mode: coarse-to-fine scan, every coarseStep-th row and window first; 0 or 1: every window, as the facedetect module
+    int refineStage;    // the windows around a coarse window reaching this stage are scanned, 0 scans them all
+    const HaarCascade* cascade; // NULL: builtinCascade; read when the pointer changes, kept by the caller until then
+    const CascadeLayout* layout; // used instead of cascade when not NULL (mapCascadeFile, buildCascadeLayout), kept by the caller
+    const MyRect* roi;  // regions of interest, roiCount rectangles of the frame; NULL: the whole frame
+    int roiCount;
+    const uint8_t* roiMask; // used instead of roi when not NULL: frame-size mask, its regions of non-zero pixels are the regions of interest
+};
+
+/* temporal-coherence mode counts, all detect calls so far */
+struct TrackingStats
+{
+    long full_scans;     // frames scanned over the whole pyramid
+    long tracking_scans; // frames scanned around the previous faces only
+    long scene_changes;  // full scans forced by a scene change
+};
+
+/* cascade work counts, all frames so far */
+struct ScanStats
+{
+    long frames;   // frames through the cascade
+    long windows;  // detection windows sent to the cascade
+    long skipped;  // of them, rejected by the variance floor before stage 0
+};
+
+/* fill in the parameters used by the facedetect module */
+void setDefaultParams(DetectParams* params);
+
+/* one level of the image pyramid */
+struct PyramidLevel
+{
+    fx_wide_factor_t factor; // scaling factor of the level
+    MySize winSize;     // detection window scaled up to the original image
+    MySize sz;          // size of the image scaled down
+    int first_row;      // first row of the level in a pyramid image
+};
+
+/* windows at y_bias = y_begin to y_end-1, x = x_begin to x_end-1 of one pyramid level */
+struct DetectTask
+{
+    int level;
+    int y_begin;
+    int y_end;
+    int x_begin;
+    int x_end;
+};
+
+/************************************************************
+ * facedetect_worker:
+ * the per-scale part of the pipeline (nearestNeighbor,
+ * integralImages and ScaleImage_Invoker) with its own
+ * index tables, integral image window and scaled
+ * rectangles, so several pyramid levels can be processed
+ * at the same time by different workers.
+ ***********************************************************/
+class facedetect_worker
+{
+public:
+    facedetect_worker();
+
+    /* size of the frames given to detectBand and downsample, sizes the buffers */
+    void setFrameSize(int width, int height);
+
+    /* cascade run by detectBand */
+    void setCascade(const CascadeLayout* cascade_layout);
+
+    /* DetectParams.varianceFloor */
+    void setVarianceFloor(int floor);
+
+    /* DetectParams.coarseStep and refineStage */
+    void setAdaptiveScan(int coarse, int stage);
+
+    /* windows of the last detectBand or detectBandScaled rejected by the variance floor */
+    long varianceSkipped(void) const;
+
+    /* run the cascade over a band of one pyramid level of img, the faces are appended to 'faces' in serial order; returns the number of windows */
+    long detectBand(const uint8_t* img, unsigned char* level_image, const PyramidLevel& level, const DetectTask& task, int shift_step, int engine, std::vector<MyRect>& faces);
+
+    /* down-sample img to one level, rows of frame-width bytes */
+    void downsample(const uint8_t* img, const PyramidLevel& level, unsigned char* level_image);
+
+    /* feature-scaling mode: the same band with the features scaled over the integral images of the whole frame */
+    template<typename SUM_T, typename SQSUM_T>
+    long detectBandScaled(const SUM_T* sum, const SQSUM_T* sqsum, const PyramidLevel& level, const DetectTask& task, int shift_step, std::vector<MyRect>& faces);
+
+private:
+    int engine;
+
+    myCascade cascadeObj;
+
+    int frame_width;
+    int frame_height;
+    const uint8_t* in_img_buffer; // caller's frame, frame_height rows of frame_width pixels
+    const unsigned char* level_src; // level down-sampled ahead (facedetect_stream), NULL: sampled from in_img_buffer
+    std::vector<int> x_index;       // column of in_img_buffer of each column of the current level
+    std::vector<int> y_index;       // row of in_img_buffer of each row of the current level
+    std::vector<unsigned char> row_buffer; // one level row sampled through the index tables, MAX_WINDOW_COLS pixels
+    std::vector<int> int_img_buffer; //integral image buffer, a ring of 25 rows stored twice (integralmages_lastrow)
+    std::vector<int> sq_int_buffer; // squared integral image buffer
+    bool simd_integral;             // integral image rows with integralRowSimd
+    int norm_lanes;                 // varianceNormSimd lanes, 0 for one window at a time
+    int var_floor;                  // DetectParams.varianceFloor
+    long variance_skipped;          // windows rejected by var_floor in the current band
+    int coarse_step;                // DetectParams.coarseStep
+    int refine_stage;               // DetectParams.refineStage
+    std::vector<unsigned char> refine_mark; // scanAdaptive: windows of the range, 1 to run in the fine pass, 2 run
+    std::vector<MyPoint> refine_faces;      // and the windows passing, level coordinates
+    int window_row;                 // buffer row of the top of the integral image window
+    int* sum_window;                // &int_img_buffer[window_row*width]
+    int* sqsum_window;              // &sq_int_buffer[window_row*width]
+    const int* window_rows[25];     // the rows of sum_window, for the compiled cascade (make host_compiled)
+    std::vector<MyRect>* face_list; // where recordFace stores the faces of the current level
+    int scan_x_offset;              // column of the level where the integral image window starts
+
+    /* rectangle offsets of the current window width, from rect_tables */
+    struct RectOffsetTable
+    {
+        int width;
+        long last_use;
+        std::vector<rect_offset_t> offsets;
+        std::vector<rect_offset_t> corners; // the corners of each stage, for the gather kernels
+#ifdef PACKED_CLASSIFIERS
+        std::vector<unsigned char> storage; // the records, from the first 64-byte boundary
+        WeakClassifier* records;
+#endif
+    };
+    std::vector<RectOffsetTable> rect_tables; // capacity reserved, the tables never move
+    long rect_uses;
+    const rect_offset_t* scaled_rectangles_array;
+    const rect_offset_t* corner_offsets;
+#ifdef PACKED_CLASSIFIERS
+    const WeakClassifier* classifiers;        // records of the current window width
+#endif
+    const CascadeLayout* layout;    // cascade and its stage_limit
+    std::vector<int> survivor_x;    // stage-major engine: windows of the row still alive
+    std::vector<int> survivor_norm; // and their variance_norm_factor
+    std::vector<int> survivor_sum;  // and their sum for the current stage
+
+    /* feature-scaling mode: the features of the layout scaled to the window of one level */
+    double scaled_factor;           // factor of the tables, exact for fx_wide_factor_t, -1 when not built
+    int scaled_width;               // frame width of the offsets
+    std::vector<int> scaled_offsets;      // 12 per feature, corners in the frame integral images
+    std::vector<int64_t> scaled_weights;  // 3 per feature, times 65536, for the sums of the 24 x 24 window
+    int scaled_var_offsets[4];      // corners of the variance window
+    uint64_t scaled_var_ratio;      // 23 x 23 over the pixels of the variance window, times 2^32
+
+    /* windows x_begin to x_end-1 of the rows of a band, in one integral image window */
+    long scanColumns( const PyramidLevel& level, int y_begin, int y_end, int x_begin, int x_end, int shift_step);
+
+    /* the same windows, coarse grid first, then around the coarse windows reaching refine_stage */
+    long scanAdaptive( const PyramidLevel& level, int y_begin, int y_end, int x_begin, int x_end, int shift_step);
+
+    /* sum_window and sqsum_window at window_row */
+    void setWindowRows( int cols);
+
+    /* sets images for haar classifier cascade */
+    void setImageForCascadeClassifier(  int width);
+
+    void buildRectOffsets( rect_offset_t* offsets, int width);
+
+#ifdef PACKED_CLASSIFIERS
+    void buildClassifiers( WeakClassifier* records, const rect_offset_t* offsets);
+#endif
+
+    void updatePvalue(  int* sum, int* sqsum, int p_offset, int pq_offset, int width);
+
+    unsigned int varianceNormFactor( int p_offset, int width);
+
+    /* variance_norm_factor of the windows at x_begin, x_begin+step, ... below x_end, 0 below var_floor; returns how many */
+    int varianceNorms( int x_begin, int x_end, int step, int width, int* norm);
+
+    /* grey-level variance of the sums of an area-pixel window below var_floor */
+    bool belowVarianceFloor( int64_t sum, int64_t sqsum, int64_t area);
+
+    /* the windows of norm[0..n-1] rejected by var_floor into variance_skipped */
+    void countSkipped( const int* norm, int n);
+
+    /* runs the cascade on the specified window */
+    int runCascadeClassifier( MyPoint pt, int start_stage, int width, unsigned int variance_norm_factor);
+
+    void ScaleImage_Invoker( fx_wide_factor_t factor, int sum_col, int shift_step, int y_bias);
+
+    void setCascadeView( CascadeView* view, int sum_col);
+
+    int ScaleImage_Invoker_simd( fx_wide_factor_t factor, MySize winSize, int sum_col, int shift_step, int x2, int y_bias);
+
+    int ScaleImage_Invoker_stagemajor( fx_wide_factor_t factor, MySize winSize, int sum_col, int shift_step, int x2, int y_bias);
+
+    void recordFace( int x, int y_bias, fx_wide_factor_t factor, MySize winSize);
+
+    /* feature of the layout with NRECTS rectangles */
+    template<int NRECTS>
+    int evalWeakClassifier(int variance_norm_factor, int p_offset, int feature );
+
+    template<int NRECTS>
+    void stageFeatures( int j_begin, int j_end, int first, int n);
+
+    /* level rows row_begin to row_begin+height-1, from the column scan_x_offset */
+    void integralImages( int row_begin, int *sumData, int *sqsumData, int width, int height);
+
+    void integralmages_lastrow( int *sumData, int *sqsumData, int width, int y_bias);
+
+    /* scaled_offsets and scaled_weights of a level */
+    void scaleFeatures( fx_wide_factor_t factor);
+
+    /* runCascadeClassifier on the frame integral images, for the window at p_offset */
+    template<typename SUM_T, typename SQSUM_T>
+    int runScaledCascade( const SUM_T* sum, const SQSUM_T* sqsum, int p_offset);
+
+    /* x_index and y_index of a width x height level */
+    void scaleIndexTables( int width, int height);
+
+    /* 'cols' pixels of a level row from the column scan_x_offset */
+    const unsigned char* levelRow( int row, int cols);
+
+    /* dst rows are frame_width bytes apart */
+    void nearestNeighbor ( unsigned char* dst, int width, int height, int row_begin, int row_end);
+};
+
+/************************************************************
+ * facedetect_host:
+ * the same pipeline as the facedetect SC_MODULE
+ * (nearestNeighbor, integralImages, ScaleImage_Invoker and
+ * groupRectangles), but called directly instead of being
+ * scheduled by the SystemC kernel. The results are
+ * bit-identical to the SystemC model. On 360x240 frames
+ * the candidates are limited to the module's first
+ * MAX_NUM_FACE-1; larger frames keep all of them.
+ *
+ * With params.threads > 1 the pyramid levels, cut into
+ * horizontal bands of window rows, are run by that many
+ * facedetect_workers through a work-stealing scheduler,
+ * and their faces are merged in level and band order
+ * before groupRectangles, so the result does not depend
+ * on the number of threads.
+ *
+ * With params.scanMode == SCAN_FEATURES the integral
+ * images of the frame are computed once, and the levels
+ * scale the features instead of the image.
+ *
+ * With regions of interest (params.roi or params.roiMask)
+ * only the windows lying inside one of them are scanned:
+ * each region is mapped to the window positions of every
+ * level, and the bands cover those positions only, so the
+ * integral image rows and columns, the windows and the
+ * whole levels outside the regions are skipped. The faces
+ * are the ones of a full scan that lie inside a region.
+ * A mask is taken as the bounding boxes of its 8-connected
+ * regions of non-zero pixels.
+ *
+ * With params.coarseStep > 1 the pyramid mode scans a
+ * coarse grid of windows first, then the full grid only
+ * around the windows that got deep into the cascade.
+ *
+ * With params.trackInterval > 0 consecutive calls are
+ * taken as frames of a video: between full scans only the
+ * neighbourhood of the faces found in the previous frame
+ * is scanned, at the scales next to theirs.
+ ***********************************************************/
+class facedetect_host
+{
+public:
+    facedetect_host();
+    ~facedetect_host();
+
+    /* detect faces in a width x height 8-bit grayscale frame, returns the number of faces or -1 */
+    int detect(const uint8_t* img, int width, int height, const DetectParams& params, std::vector<MyRect>& faces);
+
+    /* task, steal and thread-time counts of all detect calls so far */
+    void getSchedulerStats(SchedulerStats* stats) const;
+
+    void getScanStats(ScanStats* stats) const;
+
+    void getTrackingStats(TrackingStats* stats) const;
+
+    /* forget the previous frame, the next frame gets a full scan */
+    void resetTracking(void);
+
+    /**********************************************************
+     * detect split into the stages of facedetect_stream,
+     * each stage can run on its own facedetect_host:
+     * setParams, then per frame buildPyramidImages into a
+     * buffer of pyramidRows() rows of width bytes,
+     * detectCandidates on that buffer and groupCandidates
+     *********************************************************/
+    int setParams(int width, int height, const DetectParams& params);
+    int pyramidRows(void) const;
+    void buildPyramidImages(const uint8_t* img, unsigned char* pyramid);
+    int detectCandidates(unsigned char* pyramid, std::vector<MyRect>& candidates);
+    int groupCandidates(const std::vector<MyRect>& candidates, std::vector<MyRect>& faces);
+
+private:
+    fx_scale_t scaleFactor;
+    int shiftStep;
+    int minNeighbours;
+    MySize minSize;
+    int engine;
+    int scanMode;
+    int threads;
+    int bandRows;
+    int trackInterval;
+    int sceneChange;
+    int varianceFloor;
+    int coarseStep;
+    int refineStage;
+    int frame_width;
+    int frame_height;
+
+    myCascade cascadeObj;
+    const HaarCascade* cascade;    // params.cascade of the layout
+    CascadeLayout* own_layout;     // layout of a cascade given in the parameters
+    const CascadeLayout* layout;   // params.layout, own_layout or builtinLayout
+
+    const uint8_t* in_img_buffer; // caller's frame, frame_height rows of frame_width pixels
+    unsigned char* pyramid_images; // levels down-sampled by buildPyramidImages, NULL when the workers down-sample
+    int pyramid_rows;
+    int face_number;
+    std::vector<MyRect> face_coordinate; //store the output coordinates, one per candidate before grouping
+    std::vector<uint32_t> frame_sum;   // feature-scaling mode: integral image of the frame
+    std::vector<uint32_t> frame_sqsum; // and squared integral image, 32-bit wrap-around when the largest window allows
+    std::vector<uint64_t> frame_sum_wide;   // 64-bit frame_sum, when the sums of the largest window do not fit 32 bits
+    std::vector<uint64_t> frame_sqsum_wide; // 64-bit frame_sqsum, likewise
+
+    std::vector<facedetect_worker*> workers;      // one per thread, created on first use
+    std::vector<PyramidLevel> levels;              // pyramid levels of the current frame
+    std::vector<MyRect> roi_rects;                 // regions of interest of the parameters, empty for the whole frame
+    std::vector< std::vector<DetectTask> > scan_regions; // windows of each level inside them, disjoint
+    std::vector<DetectTask> tasks;                 // bands of the levels, in serial order
+    std::vector<long> task_cost;                   // estimated cost of each task
+    long band_target;                              // estimated cost of a band, 0 for whole levels
+
+    bool tracking_scan;                            // the current frame is scanned around prev_faces only
+    std::vector<MyRect> prev_faces;                // faces of the previous frame
+    std::vector<unsigned char> prev_sample;        // sample of the previous frame for the scene-change test
+    int frames_since_full;
+    TrackingStats tracking_stats;
+    std::vector< std::vector<MyRect> > task_faces; // faces found in each task
+    std::vector<long> task_windows;                // windows scanned by each task
+    std::vector<long> task_skipped;                // and rejected by the variance floor
+    ScanStats scan_stats;
+    task_scheduler scheduler;
+
+    void groupRectangles( int groupThreshold, fx_scale_t eps);
+
+    int partition(int* labels, fx_scale_t eps);
+
+    int predicate(fx_scale_t eps, const MyRect& r1, const MyRect& r2);
+
+    /* list the pyramid levels in the order of the serial factor loop */
+    void buildPyramid( MySize minSize, fx_scale_t scaleFactor);
+
+    /* scan_regions of the levels */
+    void buildScanRegions(void);
+
+    /* cut the levels into bands, of band_rows window rows or sized by cost */
+    void buildTasks( int nthreads, int band_rows, int shift_step);
+
+    void setBandTarget( int nthreads, int shift_step);
+
+    void addTasks( int l, int y_begin, int y_end, int x_begin, int x_end, int band_rows, int shift_step);
+
+    /* only around the faces of the previous frame */
+    void buildTrackingTasks( int nthreads, int band_rows, int shift_step);
+
+    bool needFullScan( const uint8_t* img);
+
+    /* feature-scaling mode: frame_sum and frame_sqsum of img, or their wide versions */
+    void buildFrameIntegral( const uint8_t* img);
+
+    /* process all tasks with 'nthreads' workers */
+    void runTasks( int nthreads, int shift_step);
+
+    /* all windows passing the cascade, in serial order, into face_coordinate */
+    void findCandidates( int shift_step);
+
+    void detectObjects(MySize minSize, fx_scale_t scale_factor, int min_neighbors, int shift_step);
+};
+
+/* one-shot detection with a temporary facedetect_host */
+int detect(const uint8_t* img, int width, int height, const DetectParams& params, std::vector<MyRect>& faces);
+
+#endif
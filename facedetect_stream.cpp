@@ -0,0 +1,224 @@
+//============================================================================================
+//
+// File Name    : facedetect_stream.cpp
+// Description  : Pipelined multi-frame detection for video streams (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  submit / poll API with a stage thread per step
+//17/10/2026  1.1       UTD DARClab                  Pyramid slots sized by the frame width
+//18/10/2026  1.2       UTD DARClab                  Temporal-coherence mode rejected
+//============================================================================================
+
+/****************************************************************
+ * The stage threads wait on an empty queue by yielding for a
+ * while, then by sleeping WAIT_SLEEP_US at a time: at 30 to
+ * 60 frames per second a stage takes milliseconds per frame,
+ * so the sleep adds little latency, and idle stage threads do
+ * not take the cores the other stages need.
+ ***************************************************************/
+
+#include "facedetect_stream.h"
+
+#define WAIT_YIELDS     64
+#define WAIT_SLEEP_US   50
+
+/* the n-th time a thread finds nothing to do */
+static void waitTurn(int n)
+{
+    if( n < WAIT_YIELDS )
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(WAIT_SLEEP_US));
+}
+
+facedetect_stream::facedetect_stream()
+{
+    free_slots = NULL;
+    to_pyramid = NULL;
+    to_cascade = NULL;
+    to_group = NULL;
+    done = NULL;
+    running = false;
+    finished_frames = 0;
+    submitted_frames = 0;
+    frame_size = 0;
+}
+
+facedetect_stream::~facedetect_stream()
+{
+    stop();
+    delete free_slots;
+    delete to_pyramid;
+    delete to_cascade;
+    delete to_group;
+    delete done;
+}
+
+int facedetect_stream::start(int width, int height, const DetectParams& params, int depth)
+{
+    int i;
+
+    if( running )
+    {
+        printf("ERROR: the stream is already started\n");
+        return -1;
+    }
+    if( depth < 1 )
+    {
+        printf("ERROR: pipeline depth %d, at least 1 frame slot is needed\n", depth);
+        return -1;
+    }
+    /* the cascade of a frame would have to wait for the faces of the previous one, which serializes the stages */
+    if( params.trackInterval > 0 )
+    {
+        printf("ERROR: track interval %d, the stream scans every frame fully, trackInterval has to be 0\n", params.trackInterval);
+        return -1;
+    }
+    if( pyramid_stage.setParams(width, height, params) < 0 ||
+        cascade_stage.setParams(width, height, params) < 0 ||
+        group_stage.setParams(width, height, params) < 0 )
+        return -1;
+
+    frame_size = width*height;
+    slots.assign(depth, FrameSlot());
+    for( i = 0; i < depth; i++ )
+    {
+        slots[i].image.resize(frame_size);
+        slots[i].pyramid.resize(pyramid_stage.pyramidRows()*width);
+    }
+
+    delete free_slots;
+    delete to_pyramid;
+    delete to_cascade;
+    delete to_group;
+    delete done;
+    free_slots = new spsc_queue<int>(depth);
+    to_pyramid = new spsc_queue<int>(depth);
+    to_cascade = new spsc_queue<int>(depth);
+    to_group = new spsc_queue<int>(depth);
+    done = new spsc_queue<int>(depth);
+    for( i = 0; i < depth; i++ )
+        free_slots->push(i);
+
+    submitted_frames = 0;
+    finished_frames = 0;
+    running = true;
+    pyramid_thread = std::thread(&facedetect_stream::pyramidLoop, this);
+    cascade_thread = std::thread(&facedetect_stream::cascadeLoop, this);
+    group_thread = std::thread(&facedetect_stream::groupLoop, this);
+
+    return 0;
+}
+
+int facedetect_stream::submit(const uint8_t* img)
+{
+    int slot;
+
+    if( !running )
+    {
+        printf("ERROR: the stream is not started\n");
+        return -1;
+    }
+    if( !free_slots->pop(&slot) )
+        return 1;
+
+    slots[slot].frame = submitted_frames++;
+    slots[slot].submitted = std::chrono::steady_clock::now();
+    memcpy(slots[slot].image.data(), img, frame_size);
+    give(to_pyramid, slot);
+
+    return 0;
+}
+
+int facedetect_stream::poll(StreamResult* result)
+{
+    int slot;
+
+    if( done == NULL || !done->pop(&slot) )
+        return 0;
+
+    result->frame = slots[slot].frame;
+    result->faces = slots[slot].faces;
+    result->latency = std::chrono::duration<double>(slots[slot].finished - slots[slot].submitted).count();
+    give(free_slots, slot);
+
+    return 1;
+}
+
+void facedetect_stream::stop(void)
+{
+    if( !running )
+        return;
+
+    int n = 0;
+
+    while( finished_frames < submitted_frames )
+        waitTurn(n++);
+
+    running = false;
+    pyramid_thread.join();
+    cascade_thread.join();
+    group_thread.join();
+}
+
+bool facedetect_stream::take(spsc_queue<int>* in, int* slot)
+{
+    int n = 0;
+
+    while( !in->pop(slot) )
+    {
+        if( !running )
+            return false;
+        waitTurn(n++);
+    }
+    return true;
+}
+
+/* every queue can hold all the slots, so this only waits when the consumer is behind on reading */
+void facedetect_stream::give(spsc_queue<int>* out, int slot)
+{
+    int n = 0;
+
+    while( !out->push(slot) )
+        waitTurn(n++);
+}
+
+void facedetect_stream::pyramidLoop(void)
+{
+    int slot;
+
+    while( take(to_pyramid, &slot) )
+    {
+        pyramid_stage.buildPyramidImages(slots[slot].image.data(), slots[slot].pyramid.data());
+        give(to_cascade, slot);
+    }
+}
+
+void facedetect_stream::cascadeLoop(void)
+{
+    int slot;
+
+    while( take(to_cascade, &slot) )
+    {
+        cascade_stage.detectCandidates(slots[slot].pyramid.data(), slots[slot].candidates);
+        give(to_group, slot);
+    }
+}
+
+void facedetect_stream::groupLoop(void)
+{
+    int slot;
+
+    while( take(to_group, &slot) )
+    {
+        group_stage.groupCandidates(slots[slot].candidates, slots[slot].faces);
+        slots[slot].finished = std::chrono::steady_clock::now();
+        give(done, slot);
+        finished_frames++;
+    }
+}
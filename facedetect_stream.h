@@ -0,0 +1,118 @@
+//============================================================================================
+//
+// File Name    : facedetect_stream.h
+// Description  : Pipelined multi-frame detection for video streams (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  submit / poll API with a stage thread per step
+//18/10/2026  1.1       UTD DARClab                  Temporal-coherence mode rejected
+//============================================================================================
+
+#ifndef FACEDETECT_STREAM_H
+#define FACEDETECT_STREAM_H
+
+#include "facedetect_host.h"
+#include "spsc_queue.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+/* detections of one frame */
+struct StreamResult
+{
+    long frame;               // number of the frame, in submit order from 0
+    std::vector<MyRect> faces;
+    double latency;           // seconds from submit to the end of grouping
+};
+
+/************************************************************
+ * facedetect_stream:
+ * the detection split into three stage threads connected
+ * by lock-free SPSC queues,
+ *
+ *   submit -> pyramid (nearestNeighbor, all levels)
+ *          -> cascade (integral images, cascade, params.threads workers)
+ *          -> grouping (groupRectangles) -> poll
+ *
+ * so the pyramid of frame N+1 is built while frame N is in
+ * the cascade and frame N-1 is grouped. 'depth' frame
+ * slots are recycled: submit returns 1 while all of them
+ * are in flight, which bounds the latency to about depth
+ * frame times. The results are those of facedetect_host
+ * and come out in submit order.
+ *
+ * Every frame is scanned fully: the temporal-coherence
+ * mode would make the cascade of a frame wait for the
+ * grouping of the previous one, so start rejects
+ * params.trackInterval > 0.
+ *
+ * submit and poll may be called from two different threads,
+ * but each from a single thread.
+ ***********************************************************/
+class facedetect_stream
+{
+public:
+    facedetect_stream();
+    ~facedetect_stream();
+
+    /* start the stage threads for width x height frames, returns -1 on error (also for params.trackInterval > 0) */
+    int start(int width, int height, const DetectParams& params, int depth);
+
+    /* copy a frame into the pipeline: 0 when accepted, 1 when the pipeline is full */
+    int submit(const uint8_t* img);
+
+    /* 1 and the oldest finished frame in 'result', 0 when none is finished */
+    int poll(StreamResult* result);
+
+    /* wait for the frames in flight and stop the stage threads, the results can still be polled */
+    void stop(void);
+
+private:
+    struct FrameSlot
+    {
+        long frame;
+        std::vector<uint8_t> image;
+        std::vector<unsigned char> pyramid;
+        std::vector<MyRect> candidates;
+        std::vector<MyRect> faces;
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point finished;
+    };
+
+    std::vector<FrameSlot> slots;
+
+    /* slot indices moving through the pipeline */
+    spsc_queue<int>* free_slots;    // poll -> submit
+    spsc_queue<int>* to_pyramid;    // submit -> pyramid thread
+    spsc_queue<int>* to_cascade;    // pyramid thread -> cascade thread
+    spsc_queue<int>* to_group;      // cascade thread -> grouping thread
+    spsc_queue<int>* done;          // grouping thread -> poll
+
+    /* one facedetect_host per stage, each only used by its thread */
+    facedetect_host pyramid_stage;
+    facedetect_host cascade_stage;
+    facedetect_host group_stage;
+
+    std::thread pyramid_thread;
+    std::thread cascade_thread;
+    std::thread group_thread;
+    std::atomic<bool> running;
+    std::atomic<long> finished_frames;
+    long submitted_frames;
+    int frame_size;
+
+    void pyramidLoop(void);
+    void cascadeLoop(void);
+    void groupLoop(void);
+
+    /* wait for a slot from 'in', false when the stream is stopped */
+    bool take(spsc_queue<int>* in, int* slot);
+    void give(spsc_queue<int>* out, int slot);
+};
+
+#endif
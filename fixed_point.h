@@ -0,0 +1,183 @@
+//============================================================================================
+//
+// File Name    : fixed_point.h
+// Description  : Native unsigned fixed-point type, bit-exact with sc_ufixed<W,I,SC_RND,SC_SAT>
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  fx_ufixed / fx_val for the host build
+//============================================================================================
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+/************************************************************
+ * Two types model the SystemC fixed-point behaviour:
+ *
+ * fx_val<F>: an exact intermediate value raw/2^F, like
+ * sc_fxval. Products and sums of fixed-point numbers are
+ * exact, quantization happens only on the assignment to
+ * a fx_ufixed.
+ *
+ * fx_ufixed<W,I>: W bits, I of them integer bits, unsigned,
+ * with SC_RND quantization (add half an LSB, then floor) and
+ * SC_SAT overflow (clamp to [0, 2^I - 2^-(W-I)]), like
+ * sc_ufixed<W,I,SC_RND,SC_SAT>.
+ *
+ * All operations are integer shifts, adds and multiplies.
+ * The only inexact operation is int / fx_ufixed, which keeps
+ * FX_DIV_FBITS extra fractional bits and truncates; the
+ * detector only converts its result to int, which then
+ * equals the floor of the exact quotient.
+ ***********************************************************/
+
+#define FX_DIV_FBITS 16
+
+template<int F>
+struct fx_val
+{
+    int64_t raw;
+
+    explicit constexpr fx_val(int64_t r) : raw(r) {}
+
+    /* truncation toward zero, like the (int) cast of a sc_fxval */
+    constexpr operator int() const
+    {
+        return raw >= 0 ? (int)(raw >> F) : -(int)((-raw) >> F);
+    }
+
+    constexpr double to_double() const
+    {
+        return (double)raw / (double)((int64_t)1 << F);
+    }
+};
+
+template<int W, int I>
+class fx_ufixed
+{
+public:
+    static const int F = W - I;                              // fractional bits
+    static const int64_t RAW_MAX = ((int64_t)1 << W) - 1;    // saturation value
+
+    constexpr fx_ufixed() : raw(0) {}
+    constexpr fx_ufixed(int v) : raw(saturate((int64_t)v * ((int64_t)1 << F))) {}
+    constexpr fx_ufixed(double v) : raw(quantize_double(v)) {}
+
+    /* quantization of an exact value or of another fixed-point format */
+    template<int FS>
+    constexpr fx_ufixed(const fx_val<FS>& v) : raw(saturate(requantize<FS>(v.raw))) {}
+    template<int W2, int I2>
+    constexpr fx_ufixed(const fx_ufixed<W2,I2>& v) : raw(saturate(requantize<W2-I2>(v.get_raw()))) {}
+
+    static constexpr fx_ufixed from_raw(int64_t r) { return fx_ufixed(r, 0); }
+
+    constexpr int64_t get_raw() const { return raw; }
+    constexpr fx_val<F> value() const { return fx_val<F>(raw); }
+    constexpr operator fx_val<F>() const { return fx_val<F>(raw); }
+    constexpr double to_double() const { return value().to_double(); }
+
+    template<int W2, int I2>
+    fx_ufixed& operator*=(const fx_ufixed<W2,I2>& b)
+    {
+        raw = saturate(requantize<F + fx_ufixed<W2,I2>::F>(raw * b.get_raw()));
+        return *this;
+    }
+
+private:
+    int64_t raw;
+
+    constexpr fx_ufixed(int64_t r, int) : raw(r) {}
+
+    static constexpr int64_t saturate(int64_t r)
+    {
+        return r < 0 ? 0 : (r > RAW_MAX ? RAW_MAX : r);
+    }
+
+    /* SC_RND from FS to F fractional bits: add half an LSB, then floor */
+    template<int FS>
+    static constexpr int64_t requantize(int64_t r)
+    {
+        return FS > F ? (r + ((int64_t)1 << (FS > F ? FS - F - 1 : 0))) >> (FS > F ? FS - F : 0)
+                      : r * ((int64_t)1 << (F > FS ? F - FS : 0));
+    }
+
+    static constexpr int64_t quantize_double(double v)
+    {
+        return v * (double)((int64_t)1 << F) + 0.5 <= 0 ? 0
+             : v * (double)((int64_t)1 << F) + 0.5 >= (double)(RAW_MAX + 1) ? RAW_MAX
+             : (int64_t)(v * (double)((int64_t)1 << F) + 0.5);
+    }
+};
+
+/* products and sums are exact */
+template<int W1, int I1, int W2, int I2>
+constexpr fx_val<W1-I1+W2-I2> operator*(const fx_ufixed<W1,I1>& a, const fx_ufixed<W2,I2>& b)
+{
+    return fx_val<W1-I1+W2-I2>(a.get_raw() * b.get_raw());
+}
+
+template<int W, int I>
+constexpr fx_val<W-I> operator*(int a, const fx_ufixed<W,I>& b)
+{
+    return fx_val<W-I>((int64_t)a * b.get_raw());
+}
+
+template<int W, int I>
+constexpr fx_val<W-I> operator*(const fx_ufixed<W,I>& a, int b)
+{
+    return fx_val<W-I>(a.get_raw() * (int64_t)b);
+}
+
+template<int F>
+constexpr fx_val<F> operator*(const fx_val<F>& a, int b)
+{
+    return fx_val<F>(a.raw * (int64_t)b);
+}
+
+template<int F>
+constexpr fx_val<F> operator*(int a, const fx_val<F>& b)
+{
+    return fx_val<F>((int64_t)a * b.raw);
+}
+
+template<int W1, int I1, int W2, int I2>
+constexpr fx_val<(W1-I1 > W2-I2) ? W1-I1 : W2-I2> operator+(const fx_ufixed<W1,I1>& a, const fx_ufixed<W2,I2>& b)
+{
+    return fx_val<(W1-I1 > W2-I2) ? W1-I1 : W2-I2>(
+        a.get_raw() * ((int64_t)1 << ((W2-I2 > W1-I1) ? (W2-I2) - (W1-I1) : 0)) +
+        b.get_raw() * ((int64_t)1 << ((W1-I1 > W2-I2) ? (W1-I1) - (W2-I2) : 0)));
+}
+
+/* the only inexact operation, see the note at the top of the file */
+template<int W, int I>
+constexpr fx_val<FX_DIV_FBITS> operator/(int a, const fx_ufixed<W,I>& b)
+{
+    return fx_val<FX_DIV_FBITS>((int64_t)a * ((int64_t)1 << (W - I + FX_DIV_FBITS)) / b.get_raw());
+}
+
+/* exact comparisons between an integer and a fixed-point value */
+template<int F>
+constexpr bool operator<(int a, const fx_val<F>& b) { return (int64_t)a * ((int64_t)1 << F) < b.raw; }
+template<int F>
+constexpr bool operator<=(int a, const fx_val<F>& b) { return (int64_t)a * ((int64_t)1 << F) <= b.raw; }
+template<int F>
+constexpr bool operator>(int a, const fx_val<F>& b) { return (int64_t)a * ((int64_t)1 << F) > b.raw; }
+template<int F>
+constexpr bool operator>=(int a, const fx_val<F>& b) { return (int64_t)a * ((int64_t)1 << F) >= b.raw; }
+
+template<int W, int I>
+constexpr bool operator<(int a, const fx_ufixed<W,I>& b) { return a < b.value(); }
+template<int W, int I>
+constexpr bool operator<=(int a, const fx_ufixed<W,I>& b) { return a <= b.value(); }
+template<int W, int I>
+constexpr bool operator>(int a, const fx_ufixed<W,I>& b) { return a > b.value(); }
+template<int W, int I>
+constexpr bool operator>=(int a, const fx_ufixed<W,I>& b) { return a >= b.value(); }
+
+#endif
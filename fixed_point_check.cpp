@@ -0,0 +1,356 @@
+//============================================================================================
+//
+// File Name    : fixed_point_check.cpp
+// Description  : Checks the native fixed-point types against sc_ufixed (make fixed_check)
+// Release Date : 18/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//18/10/2026  1.0       UTD DARClab                  fx_ufixed compared with sc_ufixed over the detector's values
+//18/10/2026  1.1       UTD DARClab                  fx_wide_recip_t of the large classes
+//============================================================================================
+
+#include "define.h"
+#include "fixed_point.h"
+#include "facedetect_host.h"
+#include <math.h>
+
+/*******************************************************
+ * Every fixed-point operation of the facedetect module
+ * and of the host build is run with the SystemC types
+ * of define.h and with fx_ufixed of the same formats,
+ * and the raw values (or the integers the detector takes
+ * from them) have to be the same. The inputs cover the
+ * values the detector can give each operation, most of
+ * them exhaustively: every raw value of a format, every
+ * pair of raw values of the pyramid step, every coordinate
+ * and size of a 360x240 frame and of the host frames up
+ * to MAX_FRAME_SIZE.
+ ******************************************************/
+
+/* the formats as native and as SystemC types */
+struct native_fx
+{
+    template<int W, int I> struct ufixed { typedef fx_ufixed<W,I> type; };
+};
+
+struct systemc_fx
+{
+    template<int W, int I> struct ufixed { typedef sc_ufixed<W,I,SC_RND,SC_SAT> type; };
+};
+
+#define MAX_REPORTED 5
+
+struct Check
+{
+    const char* name;
+    long cases;
+    long mismatches;
+};
+
+static void startCheck( Check& c, const char* name)
+{
+    c.name = name;
+    c.cases = 0;
+    c.mismatches = 0;
+}
+
+static void compare( Check& c, int64_t native, int64_t systemc, double a, double b)
+{
+    c.cases++;
+    if( native == systemc )
+        return;
+    if( c.mismatches < MAX_REPORTED )
+        printf("MISMATCH %s (%.10g, %.10g): native %lld, systemc %lld\n", c.name, a, b, (long long)native, (long long)systemc);
+    c.mismatches++;
+}
+
+static long endCheck( const Check& c)
+{
+    printf("%-44s %10ld cases  %ld mismatches\n", c.name, c.cases, c.mismatches);
+    return c.mismatches;
+}
+
+/* raw value of a number with F fractional bits, exact through to_double */
+template<class V>
+static int64_t rawValue( const V& v, int F)
+{
+    return (int64_t)ldexp(v.to_double(), F);
+}
+
+template<class T, int W, int I>
+static typename T::template ufixed<W,I>::type fromRaw( int64_t raw)
+{
+    return typename T::template ufixed<W,I>::type(ldexp((double)raw, -(W - I)));
+}
+
+/* constants, the scale factor read from parameter.txt and 1.0/weight */
+template<class T, int W, int I>
+static int64_t fromDouble( double d)
+{
+    typename T::template ufixed<W,I>::type v = d;
+    return rawValue(v, W - I);
+}
+
+template<class T, int W, int I>
+static int64_t fromFloat( float f)
+{
+    typename T::template ufixed<W,I>::type v = f;
+    return rawValue(v, W - I);
+}
+
+template<class T, int W, int I>
+static int64_t fromInt( int a)
+{
+    typename T::template ufixed<W,I>::type v = a;
+    return rawValue(v, W - I);
+}
+
+/* factor *= scaleFactor, the step of the pyramid loop */
+template<class T, int WF, int IF>
+static int64_t pyramidStep( int64_t factor_raw, int64_t scale_raw)
+{
+    typename T::template ufixed<WF,IF>::type factor = fromRaw<T,WF,IF>(factor_raw);
+
+    factor *= fromRaw<T,8,1>(scale_raw);
+    return rawValue(factor, WF - IF);
+}
+
+/* myRound(a*factor): window sizes, face coordinates, scaled features, eps margins */
+template<class T, int WF, int IF, int WR, int IR>
+static int64_t roundProduct( int a, int64_t factor_raw)
+{
+    typedef typename T::template ufixed<WR,IR>::type round_t;
+    round_t value = a*fromRaw<T,WF,IF>(factor_raw);
+
+    return (int)(value + (round_t)0.5);
+}
+
+/* size/factor, the size of a pyramid level */
+template<class T, int WF, int IF>
+static int64_t divide( int a, int64_t factor_raw)
+{
+    int q = a/fromRaw<T,WF,IF>(factor_raw);
+
+    return q;
+}
+
+/* stage_sum < 0.4*stage threshold */
+template<class T>
+static int64_t stageTest( int stage_sum, int thresh)
+{
+    typedef typename T::template ufixed<8,1>::type scale_t;
+
+    return stage_sum < (scale_t)0.4*thresh;
+}
+
+/* the delta of predicate, its raw value and the tests of the distances around it */
+template<class T, int WD, int ID>
+static int64_t predicateDelta( int64_t eps_raw, int sizes)
+{
+    typedef typename T::template ufixed<WD,ID>::type delta_t;
+    delta_t delta = (delta_t)0.5*fromRaw<T,8,1>(eps_raw)*sizes;
+    int d = (int)delta.to_double();
+
+    return rawValue(delta, WD - ID)*4 + (d <= delta)*2 + (d + 1 <= delta);
+}
+
+/* myRound(sum*s) with s = 1.0/weight, the average of a class in groupRectangles */
+template<class T, int WS, int IS, int WR, int IR>
+static int64_t classAverage( int sum, int weight)
+{
+    typedef typename T::template ufixed<WR,IR>::type round_t;
+    typename T::template ufixed<WS,IS>::type s = 1.0/weight;
+    round_t value = sum*s;
+
+    return (int)(value + (round_t)0.5);
+}
+
+/* every quarter of an LSB from below 0 to above the saturation value, and the integers around the range */
+template<int W, int I>
+static long checkConversions( const char* name)
+{
+    Check c;
+    char title[64];
+    int64_t k;
+    int a;
+    long mismatches;
+
+    sprintf(title, "%s <%d,%d> from double", name, W, I);
+    startCheck(c, title);
+    for( k = -8; k <= (((int64_t)1 << I) + 1) << (W - I + 2); k++ )
+    {
+        double d = ldexp((double)k, -(W - I + 2));
+        compare(c, fromDouble<native_fx,W,I>(d), fromDouble<systemc_fx,W,I>(d), d, 0);
+    }
+    mismatches = endCheck(c);
+
+    sprintf(title, "%s <%d,%d> from int", name, W, I);
+    startCheck(c, title);
+    for( a = -4; a <= (1 << I) + 4; a++ )
+        compare(c, fromInt<native_fx,W,I>(a), fromInt<systemc_fx,W,I>(a), a, 0);
+    return mismatches + endCheck(c);
+}
+
+/* the scale factors of parameter.txt, floats from 1 to 3 by 0.001 */
+static long checkScaleFactors( void)
+{
+    Check c;
+    int k;
+
+    startCheck(c, "fx_scale_t <8,1> from float");
+    for( k = 0; k <= 2000; k++ )
+    {
+        float f = 1.0f + k*0.001f;
+        compare(c, fromFloat<native_fx,8,1>(f), fromFloat<systemc_fx,8,1>(f), f, 0);
+    }
+    return endCheck(c);
+}
+
+/* every factor times every scale factor, saturation included */
+template<int WF, int IF>
+static long checkPyramid( const char* name)
+{
+    Check c;
+    int64_t f, s;
+
+    startCheck(c, name);
+    for( f = 0; f < ((int64_t)1 << WF); f++ )
+        for( s = 0; s < 256; s++ )
+            compare(c, pyramidStep<native_fx,WF,IF>(f, s), pyramidStep<systemc_fx,WF,IF>(f, s), f, s);
+    return endCheck(c);
+}
+
+/* every factor from 1 up, every coordinate of a frame of 'size' pixels at that factor */
+template<int WF, int IF, int WR, int IR>
+static long checkRound( const char* name, int size)
+{
+    Check c;
+    int64_t f;
+    int a;
+
+    startCheck(c, name);
+    for( f = (int64_t)1 << (WF - IF); f < ((int64_t)1 << WF); f++ )
+        for( a = 0; a <= ((int64_t)size << (WF - IF))/f + 1; a++ )
+            compare(c, roundProduct<native_fx,WF,IF,WR,IR>(a, f), roundProduct<systemc_fx,WF,IF,WR,IR>(a, f), a, f);
+    return endCheck(c);
+}
+
+/* every size up to 'size' over factors from 1 up, taking one factor in 'step' */
+template<int WF, int IF>
+static long checkDivide( const char* name, int size, int step)
+{
+    Check c;
+    int64_t f;
+    int a;
+
+    startCheck(c, name);
+    for( f = (int64_t)1 << (WF - IF); f < ((int64_t)1 << WF); f += step )
+        for( a = 0; a <= size; a++ )
+            compare(c, divide<native_fx,WF,IF>(a, f), divide<systemc_fx,WF,IF>(a, f), a, f);
+    return endCheck(c);
+}
+
+/* stage thresholds of both signs, with the sums just below, at and above 0.4 of them */
+static long checkStage( void)
+{
+    Check c;
+    int t, s;
+
+    startCheck(c, "stage_sum < (fx_scale_t)0.4*thresh");
+    for( t = -65536; t <= 65536; t++ )
+        for( s = (int)(0.4*t) - 2; s <= (int)(0.4*t) + 2; s++ )
+            compare(c, stageTest<native_fx>(s, t), stageTest<systemc_fx>(s, t), s, t);
+    return endCheck(c);
+}
+
+/* every eps, every sum of a width and a height up to 'sizes' */
+template<int WD, int ID>
+static long checkDelta( const char* name, int sizes)
+{
+    Check c;
+    int64_t e;
+    int n;
+
+    startCheck(c, name);
+    for( e = 0; e < 256; e++ )
+        for( n = 0; n <= sizes; n++ )
+            compare(c, predicateDelta<native_fx,WD,ID>(e, n), predicateDelta<systemc_fx,WD,ID>(e, n), e, n);
+    return endCheck(c);
+}
+
+/* every eps, every width up to 'size' */
+template<int WR, int IR>
+static long checkEps( const char* name, int size)
+{
+    Check c;
+    int64_t e;
+    int w;
+
+    startCheck(c, name);
+    for( e = 0; e < 256; e++ )
+        for( w = 0; w <= size; w++ )
+            compare(c, roundProduct<native_fx,8,1,WR,IR>(w, e), roundProduct<systemc_fx,8,1,WR,IR>(w, e), w, e);
+    return endCheck(c);
+}
+
+/* classes of 'first' to 'last' candidates, sums of their coordinates up to weight*size, one in 'step' */
+template<int WS, int IS, int WR, int IR>
+static long checkAverage( const char* name, int first, int last, int size, int step)
+{
+    Check c;
+    int w, v;
+
+    startCheck(c, name);
+    for( w = first; w <= last; w++ )
+    {
+        compare(c, fromDouble<native_fx,WS,IS>(1.0/w), fromDouble<systemc_fx,WS,IS>(1.0/w), w, 0);
+        for( v = 0; v <= w*size; v += step )
+            compare(c, classAverage<native_fx,WS,IS,WR,IR>(v, w), classAverage<systemc_fx,WS,IS,WR,IR>(v, w), v, w);
+    }
+    return endCheck(c);
+}
+
+int sc_main(int argc, char* argv[])
+{
+    long mismatches = 0;
+
+    mismatches += checkConversions<8,1>("fx_scale_t");
+    mismatches += checkConversions<10,5>("fx_factor_t");
+    mismatches += checkConversions<16,12>("fx_round_t");
+    mismatches += checkConversions<16,8>("fx_delta_t");
+    mismatches += checkConversions<10,1>("fx_recip_t");
+    mismatches += checkConversions<14,9>("fx_wide_factor_t");
+    mismatches += checkConversions<20,16>("fx_wide_round_t");
+    mismatches += checkConversions<20,12>("fx_wide_delta_t");
+    mismatches += checkScaleFactors();
+
+    /* the facedetect module, 360x240 frames */
+    mismatches += checkPyramid<10,5>("fx_factor_t *= fx_scale_t");
+    mismatches += checkRound<10,5,16,12>("myRound(int*fx_factor_t)", IMAGE_WIDTH);
+    mismatches += checkDivide<10,5>("int/fx_factor_t", IMAGE_WIDTH, 1);
+    mismatches += checkStage();
+    mismatches += checkEps<16,12>("myRound(width*eps)", IMAGE_WIDTH);
+    mismatches += checkDelta<16,8>("fx_delta_t of predicate", IMAGE_WIDTH + IMAGE_HEIGHT);
+    mismatches += checkAverage<10,1,16,12>("myRound(sum*fx_recip_t)", 1, MAX_NUM_FACE - 1, IMAGE_WIDTH, 1);
+
+    /* the host build, frames up to MAX_FRAME_SIZE */
+    mismatches += checkPyramid<14,9>("fx_wide_factor_t *= fx_scale_t");
+    mismatches += checkRound<14,9,20,16>("myRound(int*fx_wide_factor_t)", MAX_FRAME_SIZE);
+    mismatches += checkDivide<14,9>("int/fx_wide_factor_t", MAX_FRAME_SIZE, 31);
+    mismatches += checkEps<20,16>("myRound(width*eps), wide", MAX_FRAME_SIZE);
+    mismatches += checkDelta<20,12>("fx_wide_delta_t of predicate", 2*MAX_FRAME_SIZE);
+    mismatches += checkAverage<10,1,20,16>("myRound(sum*fx_recip_t), wide", 1, MAX_NUM_FACE - 1, MAX_FRAME_SIZE, 13);
+    mismatches += checkAverage<24,1,20,16>("myRound(sum*fx_wide_recip_t)", MAX_NUM_FACE, 16*MAX_NUM_FACE, MAX_FRAME_SIZE, 4099);
+
+    if( mismatches != 0 )
+    {
+        printf("%ld mismatches\n", mismatches);
+        return 1;
+    }
+    printf("native fixed-point types match sc_ufixed\n");
+    return 0;
+}
@@ -0,0 +1,115 @@
+//============================================================================================
+//
+// File Name    : gen_cascade.cpp
+// Description  : Generator of the compiled cascade of the host build (make host_compiled)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Stages as straight-line C++ from the .dat tables
+//============================================================================================
+
+/****************************************************************
+ * Writes cascade_compiled.inc: one function per stage, each
+ * feature being one expression with its rectangles, weights,
+ * node threshold and alphas as immediate constants. The stride
+ * of the integral image window changes with the pyramid level,
+ * so a corner at (cx, cy) of the window is read as
+ * row[cy][x + cx], row[] pointing to the rows of the window:
+ * the row pointers are the only values read besides the
+ * integral image. As in runCascadeClassifier only the first
+ * 200 features of a stage are evaluated.
+ *
+ *   gen_cascade.exe cascade_compiled.inc
+ ***************************************************************/
+
+#include <stdio.h>
+
+static const int rectangles_array[34956] = {
+    #include "rectangles_array.dat"
+};
+static const int stages_array[25] = {
+    #include "stages_array.dat"
+};
+static const int weights_array[8739] = {
+    #include "weights_array.dat"
+};
+static const int alpha1_array[2913] = {
+    #include "alpha1_array.dat"
+};
+static const int alpha2_array[2913] = {
+    #include "alpha2_array.dat"
+};
+static const int tree_thresh_array[2913] = {
+    #include "tree_thresh_array.dat"
+};
+
+/* (row[y0][x+x0] - row[y0][x+x1] - row[y1][x+x0] + row[y1][x+x1])*w of rectangle k of feature j */
+static void writeRect(FILE* fp, int j, int k)
+{
+    const int* r = rectangles_array + 12*j + 4*k;
+    int x0 = r[0], y0 = r[1], x1 = r[0] + r[2], y1 = r[1] + r[3];
+
+    fprintf(fp, "(row[%d][x+%d] - row[%d][x+%d] - row[%d][x+%d] + row[%d][x+%d])*%d",
+            y0, x0, y0, x1, y1, x0, y1, x1, weights_array[3*j + k]);
+}
+
+int main(int argc, char** argv)
+{
+    int i, j, k, n, first = 0;
+    FILE* fp;
+
+    if( argc != 2 )
+    {
+        printf("usage: gen_cascade.exe cascade_compiled.inc\n");
+        return 1;
+    }
+    fp = fopen(argv[1], "w");
+    if( fp == NULL )
+    {
+        printf("ERROR: cannot write %s\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(fp, "/* generated by gen_cascade.exe from the .dat tables, do not edit */\n");
+
+    for( i = 0; i < 25; i++ )
+    {
+        n = (stages_array[i] < 200) ? stages_array[i] : 200;
+
+        fprintf(fp, "\n/* stage %d, %d features */\n", i, n);
+        fprintf(fp, "static int compiledStage%d(const int* const* row, int x, int norm)\n{\n", i);
+        fprintf(fp, "    int stage_sum = 0, sum, pass;\n");
+        for( j = first; j < first + n; j++ )
+        {
+            const int* r = rectangles_array + 12*j + 8;
+
+            fprintf(fp, "\n    sum = ");
+            for( k = 0; k < 3; k++ )
+            {
+                if( k == 2 && r[0] == 0 && r[1] == 0 && r[2] == 0 && r[3] == 0 )
+                    break;
+                if( k > 0 )
+                    fprintf(fp, "\n        + ");
+                writeRect(fp, j, k);
+            }
+            fprintf(fp, ";\n");
+            fprintf(fp, "    pass = -(sum >= %d*norm);\n", tree_thresh_array[j]);
+            fprintf(fp, "    stage_sum += (%d & pass) | (%d & ~pass);\n", alpha2_array[j], alpha1_array[j]);
+        }
+        fprintf(fp, "    return stage_sum;\n}\n");
+        first += n;
+    }
+
+    fprintf(fp, "\n/* 1 when the window at column x passes the cascade, -i when stage i rejects it */\n");
+    fprintf(fp, "static int runCompiledCascade(const int* const* row, int x, int norm, const int* stage_limit)\n{\n");
+    for( i = 0; i < 25; i++ )
+        fprintf(fp, "    if( compiledStage%d(row, x, norm) < stage_limit[%d] )\n        return -%d;\n", i, i, i);
+    fprintf(fp, "    return 1;\n}\n");
+
+    fclose(fp);
+    return 0;
+}
@@ -0,0 +1,573 @@
+//============================================================================================
+//
+// File Name    : haar_cascade.cpp
+// Description  : Haar cascades loaded at run time for the host build
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  class.txt / info.txt and OpenCV Haar XML loaders
+//18/10/2026  1.1       UTD DARClab                  Stage counts of info.txt not trusted for allocation, feature total bounded
+//============================================================================================
+
+/****************************************************************
+ * The XML reader only knows what the two OpenCV cascade formats
+ * use: elements, attributes (skipped), text, comments and the
+ * <?xml ...?> declaration. Values are converted to the integer
+ * form of class.txt by truncation, which gives back the .dat
+ * tables from OpenCV's haarcascade_frontalface_default.xml
+ * (e.g. left_val 2.0875380 -> 534, right_val -2.2172101 -> -567).
+ ***************************************************************/
+
+#include "haar_cascade.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+
+static const int rectangles_array[34956] = {
+    #include "rectangles_array.dat"
+};
+static const int stages_array[25] = {
+    #include "stages_array.dat"
+};
+static const int weights_array[8739] = {
+    #include "weights_array.dat"
+};
+static const int alpha1_array[2913] = {
+    #include "alpha1_array.dat"
+};
+static const int alpha2_array[2913] = {
+    #include "alpha2_array.dat"
+};
+static const int tree_thresh_array[2913] = {
+    #include "tree_thresh_array.dat"
+};
+static const int stages_thresh_array[25] = {
+    #include "stages_thresh_array.dat"
+};
+
+const HaarCascade& builtinCascade(void)
+{
+    static const HaarCascade cascade = {
+        std::vector<int>(stages_array, stages_array + 25),
+        std::vector<int>(stages_thresh_array, stages_thresh_array + 25),
+        std::vector<int>(rectangles_array, rectangles_array + 34956),
+        std::vector<int>(weights_array, weights_array + 8739),
+        std::vector<int>(tree_thresh_array, tree_thresh_array + 2913),
+        std::vector<int>(alpha1_array, alpha1_array + 2913),
+        std::vector<int>(alpha2_array, alpha2_array + 2913)
+    };
+    return cascade;
+}
+
+int checkCascade(const HaarCascade& cascade)
+{
+    size_t i, k, total = 0;
+
+    if( cascade.stages.empty() || cascade.stage_thresh.size() != cascade.stages.size() )
+    {
+        printf("ERROR: the cascade has %d stages and %d stage thresholds\n", (int)cascade.stages.size(), (int)cascade.stage_thresh.size());
+        return -1;
+    }
+    for( i = 0; i < cascade.stages.size(); i++ )
+    {
+        if( cascade.stages[i] < 1 )
+        {
+            printf("ERROR: stage %d of the cascade has no feature\n", (int)i);
+            return -1;
+        }
+        /* total never exceeds the tables, so it cannot overflow */
+        if( (size_t)cascade.stages[i] > cascade.alpha1.size() - total )
+        {
+            printf("ERROR: the stages of the cascade give more features than its %d\n", (int)cascade.alpha1.size());
+            return -1;
+        }
+        total += cascade.stages[i];
+    }
+    if( cascade.rectangles.size() != 12*total || cascade.weights.size() != 3*total ||
+        cascade.tree_thresh.size() != total || cascade.alpha1.size() != total || cascade.alpha2.size() != total )
+    {
+        printf("ERROR: the feature tables of the cascade do not match its %d features\n", (int)total);
+        return -1;
+    }
+    for( i = 0; i < total; i++ )
+    {
+        for( k = 0; k < 3; k++ )
+        {
+            const int* r = &cascade.rectangles[12*i + 4*k];
+
+            if( k == 2 && r[0] == 0 && r[1] == 0 && r[2] == 0 && r[3] == 0 )
+                break;
+            if( r[0] < 0 || r[1] < 0 || r[2] < 0 || r[3] < 0 ||
+                r[0] + r[2] > CASCADE_WINDOW_SIZE || r[1] + r[3] > CASCADE_WINDOW_SIZE )
+            {
+                printf("ERROR: rectangle %d of feature %d (%d %d %d %d) is not in the %d x %d window\n",
+                       (int)k, (int)i, r[0], r[1], r[2], r[3], CASCADE_WINDOW_SIZE, CASCADE_WINDOW_SIZE);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* next integer of a text table, -1 at the end of the file or on anything else */
+static int readInt(FILE* fp, int* value)
+{
+    return (fscanf(fp, "%d", value) == 1) ? 0 : -1;
+}
+
+/* the 18 values of one feature of class.txt, appended to the cascade */
+static int readTextFeature(FILE* fp, HaarCascade* c)
+{
+    int k, l, value;
+
+    for( k = 0; k < 3; k++ )
+    {
+        for( l = 0; l < 4; l++ )
+        {
+            if( readInt(fp, &value) < 0 )
+                return -1;
+            c->rectangles.push_back(value);
+        }
+        if( readInt(fp, &value) < 0 )
+            return -1;
+        c->weights.push_back(value);
+    }
+    if( readInt(fp, &value) < 0 )
+        return -1;
+    c->tree_thresh.push_back(value);
+    if( readInt(fp, &value) < 0 )
+        return -1;
+    c->alpha1.push_back(value);
+    if( readInt(fp, &value) < 0 )
+        return -1;
+    c->alpha2.push_back(value);
+    return 0;
+}
+
+/************************************************************
+ * info.txt: the number of stages, then the number of
+ * features of each stage.
+ * class.txt: for each feature of each stage 18 values,
+ * x y w h weight of its 3 rectangles, node threshold,
+ * alpha1 and alpha2, and after the last feature of a
+ * stage the stage threshold (readTextClassifier of
+ * Comashi_original/haar.cpp).
+ ***********************************************************/
+int loadTextCascade(const char* class_file, const char* info_file, HaarCascade* cascade)
+{
+    int i, j, nstages, features;
+    FILE* fp;
+    HaarCascade c;
+
+    fp = fopen(info_file, "r");
+    if( fp == NULL )
+    {
+        printf("ERROR: cannot open %s\n", info_file);
+        return -1;
+    }
+    if( readInt(fp, &nstages) < 0 || nstages < 1 )
+    {
+        printf("ERROR: %s does not start with the number of stages\n", info_file);
+        fclose(fp);
+        return -1;
+    }
+    /* the counts are not trusted before they are read, the tables grow with the file */
+    for( i = 0; i < nstages; i++ )
+    {
+        if( readInt(fp, &features) < 0 || features < 1 )
+        {
+            printf("ERROR: %s does not give the number of features of stage %d\n", info_file, i);
+            fclose(fp);
+            return -1;
+        }
+        c.stages.push_back(features);
+    }
+    fclose(fp);
+
+    fp = fopen(class_file, "r");
+    if( fp == NULL )
+    {
+        printf("ERROR: cannot open %s\n", class_file);
+        return -1;
+    }
+    c.stage_thresh.resize(nstages);
+    for( i = 0; i < nstages; i++ )
+    {
+        for( j = 0; j < c.stages[i]; j++ )
+        {
+            if( readTextFeature(fp, &c) < 0 )
+                break;
+        }
+        if( j < c.stages[i] || readInt(fp, &c.stage_thresh[i]) < 0 )
+        {
+            printf("ERROR: %s ends within stage %d, %s gives more features\n", class_file, i, info_file);
+            fclose(fp);
+            return -1;
+        }
+    }
+    fclose(fp);
+
+    if( checkCascade(c) < 0 )
+        return -1;
+    *cascade = c;
+    return 0;
+}
+
+/* an XML element, the attributes are not kept */
+struct XmlNode
+{
+    std::string name;
+    std::string text;
+    std::vector<XmlNode> children;
+};
+
+/* skip white space, comments, <?...?> and <!...> up to the next element or text */
+static void skipMarkup(const std::string& s, size_t* pos)
+{
+    while( *pos < s.size() )
+    {
+        if( isspace((unsigned char)s[*pos]) )
+            (*pos)++;
+        else if( s.compare(*pos, 4, "<!--") == 0 )
+            *pos = (s.find("-->", *pos) == std::string::npos) ? s.size() : s.find("-->", *pos) + 3;
+        else if( s.compare(*pos, 2, "<?") == 0 || (s.compare(*pos, 2, "<!") == 0) )
+            *pos = (s.find('>', *pos) == std::string::npos) ? s.size() : s.find('>', *pos) + 1;
+        else
+            break;
+    }
+}
+
+/* the element starting at s[*pos] == '<', -1 when the XML is not well formed */
+static int parseElement(const std::string& s, size_t* pos, XmlNode* node)
+{
+    size_t p = *pos + 1;
+    char quote = 0;
+
+    while( p < s.size() && !isspace((unsigned char)s[p]) && s[p] != '>' && s[p] != '/' )
+        node->name += s[p++];
+    /* attributes */
+    while( p < s.size() && (quote || (s[p] != '>' && s[p] != '/')) )
+    {
+        if( quote && s[p] == quote )
+            quote = 0;
+        else if( !quote && (s[p] == '"' || s[p] == '\'') )
+            quote = s[p];
+        p++;
+    }
+    if( p >= s.size() || node->name.empty() )
+        return -1;
+    /* <name/> */
+    if( s[p] == '/' )
+    {
+        p = s.find('>', p);
+        if( p == std::string::npos )
+            return -1;
+        *pos = p + 1;
+        return 0;
+    }
+    p++;
+
+    while( p < s.size() )
+    {
+        if( s.compare(p, 4, "<!--") == 0 || s.compare(p, 2, "<?") == 0 )
+        {
+            skipMarkup(s, &p);
+        }
+        else if( s.compare(p, 2, "</") == 0 )
+        {
+            if( s.compare(p + 2, node->name.size(), node->name) != 0 )
+                return -1;
+            p = s.find('>', p);
+            if( p == std::string::npos )
+                return -1;
+            *pos = p + 1;
+            return 0;
+        }
+        else if( s[p] == '<' )
+        {
+            node->children.push_back(XmlNode());
+            if( parseElement(s, &p, &node->children.back()) < 0 )
+                return -1;
+        }
+        else
+        {
+            node->text += s[p++];
+        }
+    }
+    return -1;
+}
+
+/* the first child named 'name', NULL when there is none */
+static const XmlNode* child(const XmlNode& node, const char* name)
+{
+    size_t i;
+
+    for( i = 0; i < node.children.size(); i++ )
+        if( node.children[i].name == name )
+            return &node.children[i];
+    return NULL;
+}
+
+/* the numbers of the text of an element */
+static std::vector<double> numbers(const XmlNode* node)
+{
+    std::vector<double> v;
+    const char* p;
+    char* end;
+
+    if( node == NULL )
+        return v;
+    p = node->text.c_str();
+    for( ;; )
+    {
+        double x = strtod(p, &end);
+        if( end == p )
+            break;
+        v.push_back(x);
+        p = end;
+    }
+    return v;
+}
+
+/* x y w h weight of the 2 or 3 rectangles of a <rects> element, appended to the cascade */
+static int addRects(const XmlNode* rects, const XmlNode* tilted, HaarCascade* c)
+{
+    size_t k;
+
+    if( rects == NULL || rects->children.size() < 2 || rects->children.size() > 3 )
+    {
+        printf("ERROR: a feature of the cascade does not have 2 or 3 rectangles\n");
+        return -1;
+    }
+    if( tilted != NULL && !numbers(tilted).empty() && numbers(tilted)[0] != 0 )
+    {
+        printf("ERROR: tilted features are not supported\n");
+        return -1;
+    }
+    for( k = 0; k < 3; k++ )
+    {
+        std::vector<double> r;
+
+        if( k < rects->children.size() )
+        {
+            r = numbers(&rects->children[k]);
+            if( r.size() != 5 )
+            {
+                printf("ERROR: a rectangle of the cascade is not x y width height weight\n");
+                return -1;
+            }
+        }
+        else
+        {
+            r.assign(5, 0.0);
+        }
+        c->rectangles.push_back((int)r[0]);
+        c->rectangles.push_back((int)r[1]);
+        c->rectangles.push_back((int)r[2]);
+        c->rectangles.push_back((int)r[3]);
+        c->weights.push_back((int)(r[4]*4096));
+    }
+    return 0;
+}
+
+/* node threshold and left / right values of a weak classifier */
+static void addNode(double threshold, double left, double right, HaarCascade* c)
+{
+    c->tree_thresh.push_back((int)(threshold*4096));
+    c->alpha1.push_back((int)(left*256));
+    c->alpha2.push_back((int)(right*256));
+}
+
+/* <size>24 24</size>, <stages> of <trees> of one-node trees, each with its <feature> */
+static int readOldFormat(const XmlNode& root, HaarCascade* c)
+{
+    size_t i, j;
+    const XmlNode* stages = child(root, "stages");
+
+    if( stages == NULL )
+    {
+        printf("ERROR: the cascade has no <stages>\n");
+        return -1;
+    }
+    for( i = 0; i < stages->children.size(); i++ )
+    {
+        const XmlNode& stage = stages->children[i];
+        const XmlNode* trees = child(stage, "trees");
+        std::vector<double> threshold = numbers(child(stage, "stage_threshold"));
+
+        if( trees == NULL || threshold.size() != 1 )
+        {
+            printf("ERROR: stage %d of the cascade has no <trees> or <stage_threshold>\n", (int)i);
+            return -1;
+        }
+        for( j = 0; j < trees->children.size(); j++ )
+        {
+            const XmlNode& tree = trees->children[j];
+            const XmlNode* node = tree.children.empty() ? NULL : &tree.children[0];
+            std::vector<double> thresh, left, right;
+
+            if( tree.children.size() != 1 || child(*node, "left_node") != NULL || child(*node, "right_node") != NULL )
+            {
+                printf("ERROR: stage %d of the cascade has a tree of more than one node\n", (int)i);
+                return -1;
+            }
+            thresh = numbers(child(*node, "threshold"));
+            left = numbers(child(*node, "left_val"));
+            right = numbers(child(*node, "right_val"));
+            if( child(*node, "feature") == NULL || thresh.size() != 1 || left.size() != 1 || right.size() != 1 )
+            {
+                printf("ERROR: a node of stage %d of the cascade has no feature, threshold or values\n", (int)i);
+                return -1;
+            }
+            if( addRects(child(*child(*node, "feature"), "rects"), child(*child(*node, "feature"), "tilted"), c) < 0 )
+                return -1;
+            addNode(thresh[0], left[0], right[0], c);
+        }
+        c->stages.push_back((int)trees->children.size());
+        c->stage_thresh.push_back((int)(threshold[0]*256));
+    }
+    return 0;
+}
+
+/* <stageType>BOOST, <featureType>HAAR, <stages> with the feature index of each stump, <features> */
+static int readNewFormat(const XmlNode& root, HaarCascade* c)
+{
+    size_t i, j;
+    const XmlNode* stages = child(root, "stages");
+    const XmlNode* features = child(root, "features");
+    const XmlNode* type = child(root, "featureType");
+
+    if( type == NULL || type->text.find("HAAR") == std::string::npos )
+    {
+        printf("ERROR: the cascade does not use Haar features\n");
+        return -1;
+    }
+    if( stages == NULL || features == NULL )
+    {
+        printf("ERROR: the cascade has no <stages> or <features>\n");
+        return -1;
+    }
+    for( i = 0; i < stages->children.size(); i++ )
+    {
+        const XmlNode& stage = stages->children[i];
+        const XmlNode* weak = child(stage, "weakClassifiers");
+        std::vector<double> threshold = numbers(child(stage, "stageThreshold"));
+
+        if( weak == NULL || threshold.size() != 1 )
+        {
+            printf("ERROR: stage %d of the cascade has no <weakClassifiers> or <stageThreshold>\n", (int)i);
+            return -1;
+        }
+        for( j = 0; j < weak->children.size(); j++ )
+        {
+            /* left right feature threshold, the two leaves being 0 and -1 for a stump */
+            std::vector<double> node = numbers(child(weak->children[j], "internalNodes"));
+            std::vector<double> leaves = numbers(child(weak->children[j], "leafValues"));
+            size_t f;
+
+            if( node.size() != 4 || leaves.size() != 2 )
+            {
+                printf("ERROR: stage %d of the cascade has a weak classifier of more than one node\n", (int)i);
+                return -1;
+            }
+            f = (size_t)node[2];
+            if( node[2] < 0 || f >= features->children.size() )
+            {
+                printf("ERROR: stage %d of the cascade uses feature %d, there are %d\n", (int)i, (int)node[2], (int)features->children.size());
+                return -1;
+            }
+            if( addRects(child(features->children[f], "rects"), child(features->children[f], "tilted"), c) < 0 )
+                return -1;
+            addNode(node[3], leaves[0], leaves[1], c);
+        }
+        c->stages.push_back((int)weak->children.size());
+        c->stage_thresh.push_back((int)(threshold[0]*256));
+    }
+    return 0;
+}
+
+int loadXmlCascade(const char* file, HaarCascade* cascade)
+{
+    FILE* fp;
+    std::string s;
+    char buffer[4096];
+    size_t n, pos = 0;
+    XmlNode storage;
+    const XmlNode* root;
+    std::vector<double> size;
+    HaarCascade c;
+
+    fp = fopen(file, "r");
+    if( fp == NULL )
+    {
+        printf("ERROR: cannot open %s\n", file);
+        return -1;
+    }
+    while( (n = fread(buffer, 1, sizeof(buffer), fp)) > 0 )
+        s.append(buffer, n);
+    fclose(fp);
+
+    skipMarkup(s, &pos);
+    if( pos >= s.size() || s[pos] != '<' || parseElement(s, &pos, &storage) < 0 )
+    {
+        printf("ERROR: %s is not an XML file\n", file);
+        return -1;
+    }
+
+    /* <opencv_storage> holds the cascade, named after the file in the old format */
+    root = storage.children.empty() ? NULL : &storage.children[0];
+    if( root == NULL )
+    {
+        printf("ERROR: %s holds no cascade\n", file);
+        return -1;
+    }
+    if( child(*root, "stageType") != NULL )
+    {
+        std::vector<double> w = numbers(child(*root, "width"));
+        std::vector<double> h = numbers(child(*root, "height"));
+        if( w.size() == 1 && h.size() == 1 )
+        {
+            size.push_back(w[0]);
+            size.push_back(h[0]);
+        }
+    }
+    else
+    {
+        size = numbers(child(*root, "size"));
+    }
+    if( size.size() != 2 || size[0] != CASCADE_WINDOW_SIZE || size[1] != CASCADE_WINDOW_SIZE )
+    {
+        printf("ERROR: the window of the cascade in %s is not %d x %d\n", file, CASCADE_WINDOW_SIZE, CASCADE_WINDOW_SIZE);
+        return -1;
+    }
+
+    if( child(*root, "stageType") != NULL )
+    {
+        if( readNewFormat(*root, &c) < 0 )
+            return -1;
+    }
+    else if( readOldFormat(*root, &c) < 0 )
+        return -1;
+
+    if( checkCascade(c) < 0 )
+        return -1;
+    *cascade = c;
+    return 0;
+}
+
+int loadCascade(const char* file, HaarCascade* cascade)
+{
+    std::string path(file);
+    size_t slash = path.find_last_of('/');
+
+    if( path.size() > 4 && path.compare(path.size() - 4, 4, ".xml") == 0 )
+        return loadXmlCascade(file, cascade);
+
+    return loadTextCascade(file, ((slash == std::string::npos) ? std::string("info.txt") : path.substr(0, slash + 1) + "info.txt").c_str(), cascade);
+}
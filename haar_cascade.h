@@ -0,0 +1,69 @@
+//============================================================================================
+//
+// File Name    : haar_cascade.h
+// Description  : Haar cascades loaded at run time for the host build
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  class.txt / info.txt and OpenCV Haar XML loaders
+//============================================================================================
+
+#ifndef HAAR_CASCADE_H
+#define HAAR_CASCADE_H
+
+#include <vector>
+
+/* detection window of every cascade, the integral image window is one more row and column */
+#define CASCADE_WINDOW_SIZE 24
+
+/****************************************************************
+ * HaarCascade:
+ * a cascade of stages of one-node weak classifiers on a 24 x 24
+ * window, in the integer form of the .dat tables (and of
+ * class.txt):
+ *   - rectangle weights and node thresholds times 4096,
+ *   - alphas (left / right values) and stage thresholds
+ *     times 256,
+ * truncated towards 0. A feature has 2 or 3 rectangles; a
+ * missing third rectangle is 0 0 0 0 with weight 0. As in the
+ * facedetect module, only the first 200 features of a stage
+ * are evaluated.
+ ***************************************************************/
+struct HaarCascade
+{
+    std::vector<int> stages;       // features of each stage
+    std::vector<int> stage_thresh; // threshold of each stage
+    std::vector<int> rectangles;   // x, y, width, height of the 3 rectangles of each feature
+    std::vector<int> weights;      // 3 per feature
+    std::vector<int> tree_thresh;  // node threshold of each feature
+    std::vector<int> alpha1;       // added to the stage sum when the feature sum is below the threshold
+    std::vector<int> alpha2;       // added otherwise
+};
+
+/* the cascade compiled into the library (the .dat files, 25 stages, 2913 features) */
+const HaarCascade& builtinCascade(void);
+
+/**********************************************************
+ * The loaders return 0, or -1 with an error message when
+ * the file cannot be read or holds something else than a
+ * cascade of one-node weak classifiers with 2 or 3 upright
+ * rectangles in a 24 x 24 window.
+ *********************************************************/
+
+/* class.txt of Comashi_original, with the stage sizes in info.txt */
+int loadTextCascade(const char* class_file, const char* info_file, HaarCascade* cascade);
+
+/* OpenCV Haar cascade, in the old (haartraining) or the new (traincascade) XML format */
+int loadXmlCascade(const char* file, HaarCascade* cascade);
+
+/* a .xml file with loadXmlCascade, otherwise a class.txt with the info.txt of the same directory */
+int loadCascade(const char* file, HaarCascade* cascade);
+
+/* 0 when the tables are consistent and the rectangles are inside the window, -1 with an error message otherwise */
+int checkCascade(const HaarCascade& cascade);
+
+#endif
@@ -0,0 +1,398 @@
+//============================================================================================
+//
+// File Name    : host_main.cpp
+// Description  : Driver for the host build of the face detector
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Run the detector library and report throughput
+//17/10/2026  1.1       UTD DARClab                  -t option for the worker threads
+//17/10/2026  1.2       UTD DARClab                  -b option for the row bands
+//17/10/2026  1.3       UTD DARClab                  Scheduler utilization report
+//17/10/2026  1.4       UTD DARClab                  -s option for the streaming API
+//17/10/2026  1.5       UTD DARClab                  -k and -c options for the video mode
+//17/10/2026  1.6       UTD DARClab                  Windows per frame and time per window
+//17/10/2026  1.7       UTD DARClab                  -a option for a cascade file
+//17/10/2026  1.8       UTD DARClab                  Mapped .hcb cascades, start-up time and memory report
+//17/10/2026  1.9       UTD DARClab                  -p option for the feature-scaling mode
+//17/10/2026  1.10      UTD DARClab                  -v option for the variance floor, skipped windows
+//17/10/2026  1.11      UTD DARClab                  -r and -R options for the regions of interest
+//17/10/2026  1.12      UTD DARClab                  -d option for the coarse-to-fine scan
+//18/10/2026  1.13      UTD DARClab                  parameter.txt read checked
+//18/10/2026  1.14      UTD DARClab                  -p help: the feature-scaling mode takes -e scalar only
+//18/10/2026  1.15      UTD DARClab                  -k help: not with -s
+//============================================================================================
+
+#include "define.h"
+#include "image.h"
+#include "facedetect_host.h"
+#include "facedetect_stream.h"
+#include <chrono>
+
+static void usage(void)
+{
+    printf("usage: facedetect_host.exe [-i image.pgm] [-n iterations] [-m minNeighbours] [-e scalar|simd|simd16|stage] [-p pyramid|features] [-v floor] [-r x,y,w,h]... [-R mask.pgm] [-d stride[,stage]] [-t threads] [-b band_rows] [-s depth] [-k interval] [-c change] [-a cascade]\n");
+    printf("  -i  input image (default %s)\n", INPUT_FILENAME);
+    printf("  -n  number of times the frame is processed for the throughput figure (default 1)\n");
+    printf("  -m  group threshold, 0 reports the windows before grouping (default 1)\n");
+    printf("  -e  cascade evaluation engine (default scalar)\n");
+    printf("  -p  scan mode: integral images of each down-sampled level, or one of the frame with the features scaled, -e scalar only (default pyramid)\n");
+    printf("  -v  windows with a grey-level variance below 'floor' are rejected before the cascade (default 0, off)\n");
+    printf("  -r  region of interest, only the windows inside one of the regions are scanned; can be repeated (default the whole frame)\n");
+    printf("  -R  regions of interest from a mask of the size of the image, the bounding boxes of its regions of non-zero pixels\n");
+    printf("  -d  coarse-to-fine scan: every 'stride'-th row and window first, then all the windows around those reaching 'stage' (default off, stage 3)\n");
+    printf("  -t  worker threads for the pyramid levels (default 1)\n");
+    printf("  -b  window rows per band of a level, 0 sizes the bands by their estimated cost (default 0)\n");
+    printf("  -s  stream the -n frames through the pipelined API with 'depth' frame slots (default off)\n");
+    printf("  -k  video mode: full scan every 'interval' frames, in between only around the last faces, not with -s (default 0, off)\n");
+    printf("  -c  video mode: mean grey-level change between frames that forces a full scan (default 12)\n");
+    printf("  -a  cascade: binary .hcb (cascade_convert.exe), OpenCV Haar .xml, or class.txt with info.txt in the same directory (default the built-in one)\n");
+    printf("scaleFactor and shiftStep are read from parameter.txt, as in the SystemC testbench\n");
+}
+
+/* peak and current resident memory of the process, from /proc/self/status where there is one */
+static void printMemory(void)
+{
+    char line[256];
+    long hwm = -1, anon = -1, file = -1;
+    FILE* fp = fopen("/proc/self/status", "r");
+
+    if( fp == NULL )
+        return;
+    while( fgets(line, sizeof(line), fp) != NULL )
+    {
+        sscanf(line, "VmHWM: %ld", &hwm);
+        sscanf(line, "RssAnon: %ld", &anon);
+        sscanf(line, "RssFile: %ld", &file);
+    }
+    fclose(fp);
+    // file-backed pages (the program, a mapped cascade) are shared by the processes using the same file
+    if( hwm >= 0 && anon >= 0 && file >= 0 )
+        printf("host: memory %ld kB peak, %ld kB anonymous, %ld kB file-backed\n", hwm, anon, file);
+}
+
+/* draw white bounding boxes around detected faces */
+static void drawRectangle(MyImage* image, MyRect r)
+{
+    int i;
+    int col = image->width;
+
+    for (i = 0; i < r.width; i++)
+    {
+        image->data[col*r.y + r.x + i] = 255;
+    }
+    for (i = 0; i < r.height; i++)
+    {
+        image->data[col*(r.y+i) + r.x + r.width] = 255;
+    }
+    for (i = 0; i < r.width; i++)
+    {
+        image->data[col*(r.y + r.height) + r.x + r.width - i] = 255;
+    }
+    for (i = 0; i < r.height; i++)
+    {
+        image->data[col*(r.y + r.height - i) + r.x] = 255;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::chrono::steady_clock::time_point main_start = std::chrono::steady_clock::now();
+    int flag;
+    int i;
+    int iterations = 1;
+    int engine = ENGINE_SCALAR;
+    int scanMode = SCAN_PYRAMID;
+    int minNeighbours = 1;
+    int threads = 1;
+    int bandRows = 0;
+    int depth = 0;
+    int trackInterval = 0;
+    int sceneChange = -1;
+    int varianceFloor = 0;
+    int coarseStep = 0;
+    int refineStage = -1;
+    const char* input_file = INPUT_FILENAME;
+    const char* cascade_file = NULL;
+    const char* mask_file = NULL;
+    std::vector<MyRect> roi;
+    MyImage maskObj;
+    HaarCascade cascade;
+    CascadeLayout* cascade_layout = NULL;
+    float scaleFactor;
+    int shiftStep;
+    MyImage imageObj;
+    MyImage *image = &imageObj;
+    DetectParams params;
+    std::vector<MyRect> result;
+    FILE *fp;
+
+    for( i = 1; i < argc; i++ )
+    {
+        if( !strcmp(argv[i], "-i") && i+1 < argc )
+            input_file = argv[++i];
+        else if( !strcmp(argv[i], "-n") && i+1 < argc )
+            iterations = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-m") && i+1 < argc )
+            minNeighbours = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-t") && i+1 < argc )
+            threads = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-b") && i+1 < argc )
+            bandRows = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-s") && i+1 < argc )
+            depth = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-k") && i+1 < argc )
+            trackInterval = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-c") && i+1 < argc )
+            sceneChange = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-v") && i+1 < argc )
+            varianceFloor = atoi(argv[++i]);
+        else if( !strcmp(argv[i], "-r") && i+1 < argc )
+        {
+            MyRect r;
+            if( sscanf(argv[++i], "%d,%d,%d,%d", &r.x, &r.y, &r.width, &r.height) != 4 )
+            {
+                usage();
+                return 1;
+            }
+            roi.push_back(r);
+        }
+        else if( !strcmp(argv[i], "-d") && i+1 < argc )
+        {
+            if( sscanf(argv[++i], "%d,%d", &coarseStep, &refineStage) < 1 )
+            {
+                usage();
+                return 1;
+            }
+        }
+        else if( !strcmp(argv[i], "-R") && i+1 < argc )
+            mask_file = argv[++i];
+        else if( !strcmp(argv[i], "-a") && i+1 < argc )
+            cascade_file = argv[++i];
+        else if( !strcmp(argv[i], "-p") && i+1 < argc )
+        {
+            i++;
+            if( !strcmp(argv[i], "pyramid") )
+                scanMode = SCAN_PYRAMID;
+            else if( !strcmp(argv[i], "features") )
+                scanMode = SCAN_FEATURES;
+            else
+            {
+                usage();
+                return 1;
+            }
+        }
+        else if( !strcmp(argv[i], "-e") && i+1 < argc )
+        {
+            i++;
+            if( !strcmp(argv[i], "scalar") )
+                engine = ENGINE_SCALAR;
+            else if( !strcmp(argv[i], "simd") )
+                engine = ENGINE_SIMD;
+            else if( !strcmp(argv[i], "simd16") )
+                engine = ENGINE_SIMD16;
+            else if( !strcmp(argv[i], "stage") )
+                engine = ENGINE_STAGE_MAJOR;
+            else
+            {
+                usage();
+                return 1;
+            }
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if( iterations < 1 )
+        iterations = 1;
+
+    printf("-- loading image --\r\n");
+    flag = readPgm((char *)input_file, image);
+    if (flag == -1)
+    {
+        printf( "Unable to open input image\n");
+        return 1;
+    }
+
+    // read from parameter.txt
+    fp = fopen("parameter.txt","r");
+    if (!fp){
+        printf("Unable to open file parameter.txt\n");
+        return 1;
+    }
+    if( fscanf(fp,"%f",&scaleFactor) != 1 || //first line
+        fscanf(fp,"%d",&shiftStep) != 1 ) //second line
+    {
+        printf("Unable to read the scale factor and shift step from parameter.txt\n");
+        fclose(fp);
+        return 1;
+    }
+    fclose(fp);
+
+    setDefaultParams(&params);
+    params.scaleFactor = scaleFactor;
+    params.shiftStep = shiftStep;
+    params.minNeighbours = minNeighbours;
+    params.engine = engine;
+    params.scanMode = scanMode;
+    params.varianceFloor = varianceFloor;
+    params.coarseStep = coarseStep;
+    if( refineStage >= 0 )
+        params.refineStage = refineStage;
+    params.threads = threads;
+    params.bandRows = bandRows;
+    params.trackInterval = trackInterval;
+    if( sceneChange >= 0 )
+        params.sceneChange = sceneChange;
+    if( !roi.empty() )
+    {
+        params.roi = roi.data();
+        params.roiCount = roi.size();
+    }
+    if( mask_file != NULL )
+    {
+        if( readPgm((char *)mask_file, &maskObj) == -1 )
+        {
+            printf( "Unable to open mask image\n");
+            return 1;
+        }
+        if( maskObj.width != image->width || maskObj.height != image->height )
+        {
+            printf( "ERROR: mask %d x %d, image %d x %d\n", maskObj.width, maskObj.height, image->width, image->height);
+            return 1;
+        }
+        params.roiMask = maskObj.data;
+    }
+    if( cascade_file != NULL )
+    {
+        int len = strlen(cascade_file);
+
+        printf("-- loading cascade --\r\n");
+        if( len > 4 && !strcmp(cascade_file + len - 4, ".hcb") )
+        {
+            // used in place, the engines read the mapped file
+            cascade_layout = mapCascadeFile(cascade_file);
+            if( cascade_layout == NULL )
+                return 1;
+            printf("host: cascade %s, %d stages, %d features evaluated\n", cascade_file, cascade_layout->nstages, cascade_layout->count);
+            params.layout = cascade_layout;
+        }
+        else
+        {
+            if( loadCascade(cascade_file, &cascade) < 0 )
+                return 1;
+            printf("host: cascade %s, %d stages, %d features\n", cascade_file, (int)cascade.stages.size(), (int)cascade.alpha1.size());
+            params.cascade = &cascade;
+        }
+    }
+
+    printf("-- detecting faces --\r\n");
+    facedetect_host detector;
+    SchedulerStats stats;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if( depth > 0 )
+    {
+        // the same frame is sent 'iterations' times, as a camera would send frames
+        facedetect_stream stream;
+        StreamResult frame_result;
+        int submitted = 0, received = 0;
+        double latency_sum = 0, latency_max = 0;
+
+        if( stream.start(image->width, image->height, params, depth) < 0 )
+            return 1;
+        while( received < iterations )
+        {
+            bool idle = true;
+            if( submitted < iterations && stream.submit(image->data) == 0 )
+            {
+                submitted++;
+                idle = false;
+            }
+            while( stream.poll(&frame_result) )
+            {
+                idle = false;
+                received++;
+                result = frame_result.faces;
+                latency_sum += frame_result.latency;
+                if( frame_result.latency > latency_max )
+                    latency_max = frame_result.latency;
+            }
+            if( idle )
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        stream.stop();
+        printf("host: stream depth %d, latency %.3f ms average, %.3f ms max\n", depth, latency_sum*1e3/received, latency_max*1e3);
+        stats.thread_time = 0;
+    }
+    else
+    {
+        for( i = 0; i < iterations; i++ )
+        {
+            if( detector.detect(image->data, image->width, image->height, params, result) < 0 )
+                return 1;
+            // start-up: image, cascade and first frame, with the cascade tables touched for the first time
+            if( i == 0 )
+                printf("host: first frame %.3f ms after start\n", std::chrono::duration<double>(std::chrono::steady_clock::now() - main_start).count()*1e3);
+        }
+        detector.getSchedulerStats(&stats);
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+
+    printf("host: face_num=%d\n", (int)result.size());
+    printf("host: %d frame(s) in %.3f ms, %.3f ms/frame, %.2f fps\n", iterations, seconds*1e3, seconds*1e3/iterations, iterations/seconds);
+
+    // share of the thread time spent in tasks, lower when threads wait for the last band
+    if( stats.thread_time > 0 )
+        printf("host: %d thread(s), utilization %.1f%%, %.1f tasks/frame, %.1f stolen/frame\n", threads,
+               100.0*stats.busy_time/stats.thread_time, (double)stats.tasks/stats.runs, (double)stats.stolen/stats.runs);
+
+    // the streaming stages have their own detectors
+    if( depth == 0 )
+    {
+        ScanStats scan;
+        detector.getScanStats(&scan);
+        if( scan.windows > 0 )
+            printf("host: %.0f windows/frame, %.2f ns/window\n", (double)scan.windows/scan.frames, seconds*1e9/scan.windows);
+        if( varianceFloor > 0 && scan.windows > 0 )
+            printf("host: %.0f windows/frame skipped by the variance floor (%.1f%%)\n", (double)scan.skipped/scan.frames, 100.0*scan.skipped/scan.windows);
+    }
+
+    if( trackInterval > 0 && depth == 0 )
+    {
+        TrackingStats tracking;
+        detector.getTrackingStats(&tracking);
+        printf("host: %ld full scan(s), %ld tracking scan(s), %ld scene change(s)\n", tracking.full_scans, tracking.tracking_scans, tracking.scene_changes);
+    }
+
+    printMemory();
+
+    // write to facenumber.txt
+    fp = fopen("facenumber.txt","w");
+    if (!fp){
+        printf("Unable to open file facenumber.txt\n");
+        return 1;
+    }
+    fprintf(fp,"%d\n",(int)result.size());
+    fclose(fp);
+
+    for(i = 0; i < (int)result.size(); i++ )
+    {
+        MyRect r = result[i];
+        printf("face %d: x=%d y=%d w=%d h=%d\n", i, r.x, r.y, r.width, r.height);
+        drawRectangle(image, r);
+    }
+
+    printf("-- saving output --\r\n");
+    flag = writePgm((char *)OUTPUT_FILENAME, image);
+
+    freeImage(image);
+    delete cascade_layout;
+    return 0;
+}
@@ -12,6 +12,7 @@
 //--------------------------------------------------------------------------------------------
 //12/11/2012  1.0   Francesco Comaschi, TU Eindhoven    Functions to manage .pgm images and integral images
 //25/03/2019  1.1   UTD DARClab	                        Add a function for debug 
+//17/10/2026  1.2   UTD DARClab                         readPgm takes the image size from the header
 //============================================================================================
 
 #include <stdio.h>
@@ -94,17 +95,39 @@ void itochar(int x, char* szBuffer, int radix)
 }
 
 
+/* next number of the pgm header, skipping white space and comment lines */
+static int pgmHeaderValue(FILE *in_file)
+{
+	int ch;
+	int value = 0;
+
+	while ((ch = fgetc(in_file)) != EOF)
+	{
+		if (ch == '#')
+		{
+			while ((ch = fgetc(in_file)) != EOF && ch != '\n');
+		}
+		else if (!isspace(ch))
+			break;
+	}
+	if (ch == EOF || !isdigit(ch))
+		return -1;
+
+	// the single white space after the number is read as well, as the header requires
+	while (ch != EOF && isdigit(ch))
+	{
+		value = value*10 + (ch - '0');
+		ch = fgetc(in_file);
+	}
+	return value;
+}
+
 int readPgm(char *fileName, MyImage *image)
 {
 	FILE *in_file;
-	char ch;
+	int ch;
 	int type;
-	char version[3];
-	char line[100];
-	char mystring [20];
-	char *pch;
-	int i;
-	long int position;
+	size_t size;
 
     //changed from 'r' to 'rb' to fix sub and cntrl-z errors since windows reads 'r' as text and 'rb' as binary
     //link to suggestion: http://stackoverflow.com/questions/15874619/reading-in-a-text-file-with-a-sub-1a-control-z-character-in-r-on-windows
@@ -121,6 +144,7 @@ int readPgm(char *fileName, MyImage *image)
 	if(ch != 'P')
 	{
 		printf("ERROR: Not valid pgm file type\n");
+		fclose(in_file);
 		return -1;
 	}
 
@@ -136,38 +160,32 @@ int readPgm(char *fileName, MyImage *image)
 	if(type != 5)
 	{
 		printf("ERROR: only pgm raw format is allowed\n");
+		fclose(in_file);
 		return -1;
 	}
-	// Skip comments
-//	char line[100];
-	while ((ch = fgetc(in_file)) != EOF && isspace(ch));
-	position = ftell(in_file);
-
-
-	// skip comments
-	if (ch == '#')
-		{
-			fgets(line, sizeof(line), in_file);
-			while ((ch = fgetc(in_file)) != EOF && isspace(ch));//increment steam position until
-			position = ftell(in_file);//ftell: get current position is stream
-		}
 
-	fseek(in_file, position-1, SEEK_SET);//originally position-1, set to -3, then changed back to -1 after 'rb' change in reading the file
+	// width, height and maximum grey value, the pixels follow
+	image->width = pgmHeaderValue(in_file);
+	image->height = pgmHeaderValue(in_file);
+	image->maxgrey = pgmHeaderValue(in_file);
+	if (image->width <= 0 || image->height <= 0 || image->maxgrey <= 0 || image->maxgrey > PGM_MAXGRAY)
+	{
+		printf("ERROR: invalid pgm header in %s\n", fileName);
+		fclose(in_file);
+		return -1;
+	}
 
-	fgets (mystring , 20, in_file);
-	pch = (char *)strtok(mystring," ");
-	image->width = atoi(pch);
-	pch = (char *)strtok(NULL," ");
-	image->height = atoi(pch);
-	fgets (mystring , 5, in_file);
-	image->maxgrey = PGM_MAXGRAY;
-	image->data = (unsigned char*)malloc(sizeof(unsigned char)*(IMAGE_HEIGHT*IMAGE_WIDTH));//new unsigned char[row*col];
+	size = (size_t)image->width*image->height;
+	image->data = (unsigned char*)malloc(sizeof(unsigned char)*size);//new unsigned char[row*col];
 	image->flag = 1;
-	for(i=0;i<(IMAGE_HEIGHT*IMAGE_WIDTH);i++)
-    //for(i=0;i<(738);i++)
+	if (fread(image->data, 1, size, in_file) != size)
 	{
-		ch = fgetc(in_file);
-		image->data[i] = (unsigned char)ch;
+		printf("ERROR: %s has less than %d x %d pixels\n", fileName, image->width, image->height);
+		free(image->data);
+		image->data = NULL;
+		image->flag = 0;
+		fclose(in_file);
+		return -1;
 	}
 
 	fclose(in_file);
@@ -296,6 +314,7 @@ void setSumImage(int width, int height, MyIntImage *image)
 }
 
 
+#ifndef NATIVE_FIXED
 // write to a pgm file "test.pgm", in order to check what's inside the buffer
 int checkImg(sc_uint<8> buffer[IMAGE_HEIGHT][IMAGE_WIDTH], int width, int height)
 {
@@ -334,3 +353,4 @@ int checkImg(sc_uint<8> buffer[IMAGE_HEIGHT][IMAGE_WIDTH], int width, int height
 	fclose(fp);
 	return 0;
 }
+#endif
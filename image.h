@@ -28,6 +28,8 @@ int freeImage(MyImage* image);
 int freeSumImage(MyIntImage* image);
 void setImage(int width, int height, MyImage *image);
 void setSumImage(int width, int height, MyIntImage *image);
+#ifndef NATIVE_FIXED
 int checkImg(sc_uint<8> buffer[IMAGE_HEIGHT][IMAGE_WIDTH], int width, int height);
+#endif
 
 #endif
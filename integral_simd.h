@@ -0,0 +1,33 @@
+//============================================================================================
+//
+// File Name    : integral_simd.h
+// Description  : SIMD rows of the integral images (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  AVX2 prefix scan of the integral image rows
+//============================================================================================
+
+#ifndef INTEGRAL_SIMD_H
+#define INTEGRAL_SIMD_H
+
+/* 1 when the CPU has the instructions of integralRowSimd, 0 otherwise */
+int integralSimdAvailable(void);
+
+/**********************************************************
+ * one row of the integral and squared integral images:
+ * sum[x] = sum_prev[x] + src[0] + ... + src[x], and sqsum
+ * the same with the squared pixels, in one pass. sum_prev
+ * and sqsum_prev are NULL for the first row of an image.
+ * The row is written again to sum_copy and sqsum_copy when
+ * they are not NULL. The values are those of the scalar
+ * loops of facedetect_worker, 32-bit wrap-around included.
+ *********************************************************/
+void integralRowSimd(const unsigned char* src, const int* sum_prev, const int* sqsum_prev,
+                     int* sum, int* sqsum, int* sum_copy, int* sqsum_copy, int width);
+
+#endif
@@ -0,0 +1,122 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+sys.path.insert(0, os.path.join(root, 'scripts'))
+from common import Agreed
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+iterations = 10
+repeats = 3
+configs = [ (2, 2), (2, 3), (2, 5), (3, 3), (3, 4), (3, 6), (4, 4), (4, 6) ]
+scale_factor = 1.2
+shift_step = 1
+overlap = 0.5
+max_window_cols = 2729 # MAX_WINDOW_COLS of facedetect_host.h
+
+def usage():
+    print('This program measures the coarse-to-fine scan of the host build of the face detector (-d stride,stage), built in a temporary directory: every stride-th row and window of each pyramid level is run first, then all the windows closer than one stride to a coarse window that reached the given stage of the cascade. For each stride and stage, the windows run per frame, the time per frame (best of several runs) and the speedup over the full scan are summed over the test images in ../testimages/ and Face.pgm, with the recall of the full scan: the share of its candidate windows (before grouping) found again, and of its faces (after grouping) found again with an intersection over union of at least 0.5. The largest stride the column tiles can hold has to run, and the next one has to be rejected.\n\n')
+    print('\t./adaptive_step.py\n')
+    print('Stride,stage pairs, iterations per run, runs, scale factor and shift step can be given:\n')
+    print('\t./adaptive_step.py --configs 2,3:3,4 -n 10 -r 3 --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, configs, iterations, repeats, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:r:',['help','configs=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '--configs':
+            configs = [ tuple(int(v) for v in c.split(',')) for c in arg.split(':') ]
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='adaptive_step_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    images = [ os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm') for k in range(image_number) ] + [ os.path.join(root, 'Face.pgm') ]
+
+    # the full scan: time, candidates and faces of each image
+    full = {}
+    for image in images:
+        full[image] = Measure(image, '')
+
+    print('scalar engine, sf='+str(scale_factor)+' ss='+str(shift_step)+', '+str(len(images))+' images, best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+    print('stride  stage  windows/frame  windows %  ms/frame  speedup  candidate recall  face recall')
+    windows_full = sum([ full[image][1] for image in images ])
+    ms_full = sum([ full[image][0] for image in images ])
+    candidates_full = sum([ len(full[image][2]) for image in images ])
+    faces_full = sum([ len(full[image][3]) for image in images ])
+    print('%6s  %5s  %13d  %9.1f  %8.3f  %7.2f  %15.1f%%  %10.1f%%' % ('full', '-', windows_full/len(images), 100.0, ms_full/len(images), 1.0, 100.0, 100.0))
+    for (stride, stage) in configs:
+        ms = 0.0
+        windows = 0
+        candidates = 0
+        faces = 0
+        for image in images:
+            run = Measure(image, '-d '+str(stride)+','+str(stage))
+            ms += run[0]
+            windows += run[1]
+            candidates += len(set(run[2]) & set(full[image][2]))
+            faces += Agreed(full[image][3], run[3], overlap)
+        print('%6d  %5d  %13d  %9.1f  %8.3f  %7.2f  %15.1f%%  %10.1f%%' % (stride, stage, windows/len(images), 100.0*windows/windows_full, ms/len(images), ms_full/ms,
+              100.0*candidates/max(candidates_full, 1), 100.0*faces/max(faces_full, 1)))
+
+    # strides too large for the column tiles of a level are rejected by setParams
+    largest = (max_window_cols - 24 - shift_step)//(2*shift_step) + 1
+    Run(images[-1], '-d '+str(largest)+',3')
+    cmd = './facedetect_host.exe -i "'+images[-1]+'" -e scalar -d '+str(largest+1)+',3'
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode == 0 or 'ERROR: coarse stride' not in proc.stdout:
+        print('Stride '+str(largest+1)+' is not rejected.')
+        sys.exit(2)
+    print('largest stride '+str(largest)+' runs, stride '+str(largest+1)+' is rejected')
+
+# best ms/frame, windows/frame, candidates and faces of an image with some options
+def Measure(image, option):
+    runs = [ Run(image, option+' -m 1') for r in range(repeats) ]
+    ms = min([ run[0] for run in runs ])
+    candidates = Run(image, option+' -m 0')[2]
+    return ms, runs[0][1], candidates, runs[0][2]
+
+# ms/frame, windows/frame and faces (x, y, w, h) of one run
+def Run(image, option):
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -e scalar '+option
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    windows = int(re.search(r'([0-9]+) windows/frame,', proc.stdout).group(1))
+    faces = [ tuple(int(v) for v in m) for m in re.findall(r'face \d+: x=(\d+) y=(\d+) w=(\d+) h=(\d+)', proc.stdout) ]
+    return ms, windows, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,111 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, time, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image = '../testimages/Face0.pgm'
+repeats = 10
+# (name, -a option of facedetect_host.exe)
+sources = [ ('compiled-in', ''), ('class.txt', '-a "'+os.path.join(root, 'Comashi_original', 'class.txt')+'"'), ('xml', '-a face.xml'), ('hcb', '-a face.hcb') ]
+
+def usage():
+    print('This program compares the start-up of the host build of the face detector with the cascade compiled into the program (the .dat tables), read from Comashi_original/class.txt, read from an OpenCV XML file and mapped from a binary cascade file (.hcb) written by cascade_convert.exe. Each is started several times on one small test image (facedetect_host.exe -n 1), and the time from the start of the program to the end of the first frame, the wall time of the process and its peak, anonymous and file-backed resident memory are reported (best of the runs). The pages of a mapped .hcb file are file-backed and shared by all the processes mapping it; the tables built from the compiled-in arrays, class.txt or XML are anonymous memory of each process. The faces found with each cascade are checked to be the same.\n\n')
+    print('\t./cascade_file.py\n')
+    print('Runs per cascade and test image can be given:\n')
+    print('\t./cascade_file.py -r 20 -i ../testimages/Face3.pgm\n\n')
+
+def main(argv):
+    global work, repeats, image
+
+    try:
+        opts, args = getopt.getopt(argv,'hr:i:',['help'])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '-i':
+            image = arg
+        else:
+            usage()
+            sys.exit(2)
+    image = os.path.abspath(image)
+
+    work = tempfile.mkdtemp(prefix='cascade_file_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write('1.2\n1\n')
+
+    WriteXml(work+'/face_detector/face.xml')
+    ret_v = os.system('cd "'+work+'/face_detector" && ./cascade_convert.exe face.hcb')
+    if ret_v != 0:
+        print('Cannot write face.hcb.\n')
+        sys.exit(2)
+
+    print('\n'+os.path.basename(image)+', best of '+str(repeats)+' runs')
+    print('cascade      first frame ms  process ms  peak kB  anonymous kB  file-backed kB  same faces')
+    reference = None
+    for (name, option) in sources:
+        runs = [ Run(option) for r in range(repeats) ]
+        if reference is None:
+            reference = runs[0][5]
+        print('%-11s  %14.3f  %10.3f  %7d  %12d  %14d  %10s' % (name, min([ r[0] for r in runs ]), min([ r[1] for r in runs ]),
+              min([ r[2] for r in runs ]), min([ r[3] for r in runs ]), min([ r[4] for r in runs ]), 'yes' if runs[0][5] == reference else 'NO'))
+
+# the .dat tables as an OpenCV cascade in the old XML format, the values exact in binary
+def WriteXml(filename):
+    tables = {}
+    for name in ['rectangles_array', 'stages_array', 'weights_array', 'alpha1_array', 'alpha2_array', 'tree_thresh_array', 'stages_thresh_array']:
+        with open(os.path.join(root, name+'.dat')) as file:
+            tables[name] = [ int(v) for v in re.findall(r'-?[0-9]+', file.read()) ]
+    rects = tables['rectangles_array']
+    weights = tables['weights_array']
+
+    lines = ['<?xml version="1.0"?>', '<opencv_storage>', '<face type_id="opencv-haar-classifier">', '  <size>24 24</size>', '  <stages>']
+    first = 0
+    for i, n in enumerate(tables['stages_array']):
+        lines.append('    <_>')
+        lines.append('      <trees>')
+        for j in range(first, first + n):
+            lines.append('        <_><_><feature><rects>')
+            for k in range(3):
+                x, y, w, h = rects[12*j + 4*k : 12*j + 4*k + 4]
+                if k < 2 or (x, y, w, h) != (0, 0, 0, 0):
+                    lines.append('          <_>%d %d %d %d %r</_>' % (x, y, w, h, weights[3*j + k]/4096))
+            lines.append('        </rects><tilted>0</tilted></feature>')
+            lines.append('        <threshold>%r</threshold><left_val>%r</left_val><right_val>%r</right_val></_></_>' % (tables['tree_thresh_array'][j]/4096, tables['alpha1_array'][j]/256, tables['alpha2_array'][j]/256))
+        lines.append('      </trees>')
+        lines.append('      <stage_threshold>%r</stage_threshold><parent>%d</parent><next>-1</next></_>' % (tables['stages_thresh_array'][i]/256, i-1))
+        first += n
+    lines += ['  </stages>', '</face>', '</opencv_storage>']
+    with open(filename, 'w') as file:
+        file.write('\n'.join(lines)+'\n')
+
+# first frame ms, process ms, peak, anonymous and file-backed kB, faces of one run
+def Run(option):
+    cmd = './facedetect_host.exe -i "'+image+'" -n 1 '+option
+    start = time.perf_counter()
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    total = (time.perf_counter() - start)*1e3
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    first = float(re.search(r'first frame ([0-9.]+) ms', proc.stdout).group(1))
+    memory = re.search(r'memory (\d+) kB peak, (\d+) kB anonymous, (\d+) kB file-backed', proc.stdout)
+    faces = re.findall(r'face \d+: .*', proc.stdout)
+    return first, total, int(memory.group(1)), int(memory.group(2)), int(memory.group(3)), faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,60 @@
+# helpers shared by the scripts, imported from scripts/*/ with the scripts directory on sys.path
+
+# faces of a matched one to one with those of b, best intersection over union first, pairs below overlap not counted
+def Agreed(a, b, overlap):
+    pairs = []
+    for i in range(len(a)):
+        for j in range(len(b)):
+            iou = Iou(a[i], b[j])
+            if iou >= overlap:
+                pairs.append((iou, i, j))
+    pairs.sort(reverse=True)
+    used_a = set()
+    used_b = set()
+    for (iou, i, j) in pairs:
+        if i not in used_a and j not in used_b:
+            used_a.add(i)
+            used_b.add(j)
+    return len(used_a)
+
+def Iou(r1, r2):
+    w = min(r1[0]+r1[2], r2[0]+r2[2]) - max(r1[0], r2[0])
+    h = min(r1[1]+r1[3], r2[1]+r2[3]) - max(r1[1], r2[1])
+    if w <= 0 or h <= 0:
+        return 0.0
+    inter = w*h
+    return inter/float(r1[2]*r1[3] + r2[2]*r2[3] - inter)
+
+def ReadPgm(name):
+    with open(name,'rb') as file:
+        data = file.read()
+    fields = []
+    pos = 0
+    # magic number, width, height and maximum grey value, with comment lines in between
+    while len(fields) < 4:
+        while data[pos:pos+1].isspace():
+            pos += 1
+        if data[pos:pos+1] == b'#':
+            pos = data.index(b'\n', pos)
+            continue
+        end = pos
+        while not data[end:end+1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    w, h = int(fields[1]), int(fields[2])
+    return w, h, data[pos+1:pos+1+w*h]
+
+def WritePgm(name, w, h, pixels):
+    with open(name,'wb') as file:
+        file.write(('P5\n'+str(w)+' '+str(h)+'\n255\n').encode())
+        file.write(pixels)
+
+# nearest neighbour, one source row per output row
+def Resize(src, src_w, src_h, w, h):
+    cols = [ x*src_w//w for x in range(w) ]
+    rows = []
+    for y in range(h):
+        line = src[(y*src_h//h)*src_w:(y*src_h//h+1)*src_w]
+        rows.append(bytes(line[x] for x in cols))
+    return b''.join(rows)
@@ -0,0 +1,88 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+iterations = 20
+repeats = 5
+scale_factor = 1.2
+shift_step = 1
+builds = [ ('interpreted', 'facedetect_host.exe'), ('compiled', 'facedetect_host_compiled.exe') ]
+
+def usage():
+    print('This program compares the scalar engine of the host build of the face detector walking the cascade tables (make host) with the cascade compiled into straight-line code by gen_cascade.exe (make host_compiled). Both are built in a temporary directory and run on the test images in ../testimages/ and on Face.pgm. The time per frame and per detection window (best of several runs) are reported for each image, and the faces of the two builds are checked to be the same.\n\n')
+    print('\t./compiled_cascade.py\n')
+    print('Iterations per run, runs, scale factor and shift step can be given:\n')
+    print('\t./compiled_cascade.py -n 50 -r 5 --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, iterations, repeats, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:r:',['help','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='compiled_cascade_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host host_compiled')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    images = [ os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm') for k in range(image_number) ] + [ os.path.join(root, 'Face.pgm') ]
+    print('scalar engine, sf='+str(scale_factor)+' ss='+str(shift_step)+', best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+    print('image       interpreted ms/frame  ns/window  compiled ms/frame  ns/window  speedup  same faces')
+    total = { 'interpreted': 0.0, 'compiled': 0.0 }
+    for image in images:
+        ms = {}
+        ns = {}
+        faces = {}
+        for (build, exe) in builds:
+            runs = [ Run(exe, image) for r in range(repeats) ]
+            ms[build] = min([ run[0] for run in runs ])
+            ns[build] = min([ run[1] for run in runs ])
+            faces[build] = runs[0][2]
+            total[build] += ms[build]
+        print('%-10s  %20.3f  %9.2f  %17.3f  %9.2f  %7.2f  %10s' % (os.path.basename(image), ms['interpreted'], ns['interpreted'], ms['compiled'], ns['compiled'], ms['interpreted']/ms['compiled'], 'yes' if faces['interpreted'] == faces['compiled'] else 'NO'))
+    print('total       %20.3f  %9s  %17.3f  %9s  %7.2f' % (total['interpreted'], '', total['compiled'], '', total['interpreted']/total['compiled']))
+
+# ms/frame, ns/window and faces of one run
+def Run(exe, image):
+    cmd = './'+exe+' -i "'+image+'" -n '+str(iterations)+' -e scalar'
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in '+exe+'.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    ns = float(re.search(r'([0-9.]+) ns/window', proc.stdout).group(1))
+    faces = re.findall(r'face \d+: .*', proc.stdout)
+    return ms, ns, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
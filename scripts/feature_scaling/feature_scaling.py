@@ -0,0 +1,112 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+sys.path.insert(0, os.path.join(root, 'scripts'))
+from common import Agreed, ReadPgm, WritePgm, Resize
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+source_image = '../testimages/Face_ori.pgm'
+size_list = [ (1280,720), (1920,1080) ]
+iterations = 3
+repeats = 3
+threads = 1
+scale_factor = 1.2
+shift_step = 1
+overlap = 0.5
+modes = [ 'pyramid', 'features' ]
+
+def usage():
+    print('This program compares the two scan modes of the host build of the face detector, built in a temporary directory: the image pyramid (-p pyramid), where each scale is down-sampled and gets its own integral images, and feature scaling (-p features), where the integral images of the frame are computed once and the Haar rectangles are scaled to each window size. Both run the scalar evaluation on the test images in ../testimages/, on Face.pgm and on ../testimages/Face_ori.pgm resized to larger frames. The time per frame (best of several runs) and the faces of each mode are reported, with the faces of the pyramid mode also found by the feature-scaling mode (intersection over union of at least 0.5) as the agreement between the two.\n\n')
+    print('\t./feature_scaling.py\n')
+    print('Frame sizes of the resized image, iterations per run, runs, threads, scale factor, shift step and overlap can be given:\n')
+    print('\t./feature_scaling.py --sizes 1280x720,1920x1080 -n 3 -r 3 -t 1 --sf 1.2 --ss 1 --overlap 0.5\n\n')
+
+def main(argv):
+    global work, size_list, iterations, repeats, threads, scale_factor, shift_step, overlap
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:r:t:',['help','sizes=','sf=','ss=','overlap='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '-t':
+            threads = int(arg)
+        elif opt == '--sizes':
+            size_list = [ tuple(int(v) for v in s.split('x')) for s in arg.split(',') ] if arg else []
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        elif opt == '--overlap':
+            overlap = float(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='feature_scaling_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    images = [ os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm') for k in range(image_number) ] + [ os.path.join(root, 'Face.pgm') ]
+    if size_list:
+        src_w, src_h, src = ReadPgm(source_image)
+        os.mkdir(os.path.join(work, 'frames'))
+        for (w, h) in size_list:
+            frame = os.path.join(work, 'frames', str(w)+'x'+str(h)+'.pgm')
+            WritePgm(frame, w, h, Resize(src, src_w, src_h, w, h))
+            images.append(frame)
+
+    print('scalar evaluation, threads='+str(threads)+' sf='+str(scale_factor)+' ss='+str(shift_step)+', best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+    print('image            pyramid ms/frame  features ms/frame  speedup  pyramid faces  features faces  agreed')
+    total = { 'pyramid': 0.0, 'features': 0.0 }
+    found = { 'pyramid': 0, 'features': 0 }
+    agreed_total = 0
+    for image in images:
+        ms = {}
+        faces = {}
+        for mode in modes:
+            runs = [ Run(mode, image) for r in range(repeats) ]
+            ms[mode] = min([ run[0] for run in runs ])
+            faces[mode] = runs[0][1]
+            total[mode] += ms[mode]
+            found[mode] += len(faces[mode])
+        agreed = Agreed(faces['pyramid'], faces['features'], overlap)
+        agreed_total += agreed
+        print('%-15s  %16.3f  %17.3f  %7.2f  %13d  %14d  %6d' % (os.path.basename(image), ms['pyramid'], ms['features'], ms['pyramid']/ms['features'], len(faces['pyramid']), len(faces['features']), agreed))
+    print('total            %16.3f  %17.3f  %7.2f  %13d  %14d  %6d' % (total['pyramid'], total['features'], total['pyramid']/total['features'], found['pyramid'], found['features'], agreed_total))
+    if found['pyramid'] > 0 and found['features'] > 0:
+        print('agreement: %.1f%% of the pyramid faces found by feature scaling, %.1f%% of the feature-scaling faces found by the pyramid' % (100.0*agreed_total/found['pyramid'], 100.0*agreed_total/found['features']))
+
+# ms/frame and faces (x, y, w, h) of one run
+def Run(mode, image):
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -t '+str(threads)+' -e scalar -p '+mode
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    faces = [ tuple(int(v) for v in m) for m in re.findall(r'face \d+: x=(\d+) y=(\d+) w=(\d+) h=(\d+)', proc.stdout) ]
+    return ms, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
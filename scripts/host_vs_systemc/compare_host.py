@@ -0,0 +1,86 @@
+#! /usr/bin/env python3
+import os, sys, getopt, filecmp, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+scale_factor_list = [ 1.05, 1.1, 1.2, 1.5 ] # 1.05 gives more windows than the 127 the module keeps
+shift_step_list = [ 1, 2, 4 ]
+
+def usage():
+    print('This program checks that the host library build of the face detector (facedetect_host.exe) gives bit-identical results to the SystemC model (facedetect.exe). Both are built in a temporary directory, run on the test images in ../testimages/ for several scale factors and shift steps, and the face numbers and the output images (with the detected rectangles drawn) are compared. Scale factor 1.05 gives more candidate windows than the module keeps (MAX_NUM_FACE-1), and the host build has to keep the same ones.\n\n')
+    print('\t./compare_host.py\n')
+    print('Scale factors and shift steps can be given as comma separated lists:\n')
+    print('\t./compare_host.py --sf 1.2,1.3 --ss 1,3\n\n')
+
+def main(argv):
+    global work, scale_factor_list, shift_step_list
+
+    try:
+        opts, args = getopt.getopt(argv,'h',['help','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '--sf':
+            scale_factor_list = [ float(v) for v in arg.split(',') ]
+        elif opt == '--ss':
+            shift_step_list = [ int(v) for v in arg.split(',') ]
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='host_vs_systemc_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    mismatch = 0
+    for k in range(image_number):
+        ret_v = os.system('cp "'+os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm')+'" "'+work+'/face_detector/Face.pgm"')
+        if ret_v != 0 :
+            print('Cannot get the test image Face'+str(k)+'.pgm\n')
+            sys.exit(2)
+
+        for shift_step in shift_step_list:
+            for scale_factor in scale_factor_list:
+                sim = Run('facedetect.exe', shift_step, scale_factor)
+                host = Run('facedetect_host.exe', shift_step, scale_factor)
+                same = sim[0] == host[0] and filecmp.cmp(sim[1], host[1], shallow=False)
+                print('Face'+str(k)+'.pgm ss='+str(shift_step)+' sf='+str(scale_factor)+': systemc '+str(sim[0])+' faces, host '+str(host[0])+' faces, '+('match' if same else 'MISMATCH'))
+                if not same:
+                    mismatch += 1
+
+    if mismatch != 0:
+        print(str(mismatch)+' mismatching run(s).')
+        sys.exit(1)
+    print('All runs match.')
+
+def Run(executable, shift_step, scale_factor):
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    ret_v = os.system('cd "'+work+'/face_detector" && ./'+executable+' > /dev/null')
+    if ret_v != 0:
+        print('Runtime error occur in '+executable+'.')
+        sys.exit(2)
+
+    with open(work+'/face_detector/facenumber.txt','r') as file:
+        face_num = int( file.read().splitlines()[0] )
+
+    output = work+'/face_detector/Output_'+executable.split('.')[0]+'.pgm'
+    os.rename(work+'/face_detector/Output.pgm', output)
+
+    return face_num, output
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,100 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+sys.path.insert(0, os.path.join(root, 'scripts'))
+from common import ReadPgm, WritePgm, Resize
+work = '' # temporary directory it is built and run in, removed at exit
+source_image = '../testimages/Face_ori.pgm'
+size_list = [ (360,240), (640,480), (1280,720), (1920,1080), (2560,1440), (3840,2160) ]
+iterations = 3
+repeats = 3
+engine = 'simd16'
+threads = 1
+scale_factor = 1.2
+shift_step = 1
+builds = [ ('scalar', 'SIMD_INTEGRAL=0'), ('simd', 'SIMD_INTEGRAL=1') ]
+
+def usage():
+    print('This program compares the host build of the face detector computing the rows of the integral and squared integral images with the scalar loops (make host SIMD_INTEGRAL=0) and with the AVX2 prefix scan (the default), both built in a temporary directory. The source image (../testimages/Face_ori.pgm by default) is resized with nearest neighbour to each frame size from 360x240 to 3840x2160, and the time per frame of both builds (best of several runs) and the faces are reported. The integral images are computed per band of window rows, so with -t the bands, and their integral images, are spread over the worker threads.\n\n')
+    print('\t./integral_simd.py\n')
+    print('Frame sizes, source image, iterations per run, runs, engine (scalar, simd, simd16, stage), threads, scale factor and shift step can be given:\n')
+    print('\t./integral_simd.py --sizes 640x480,3840x2160 -i ../testimages/Face0.pgm -n 3 -r 3 --engine simd16 -t 4 --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, source_image, size_list, iterations, repeats, engine, threads, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hi:n:r:t:',['help','sizes=','engine=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-i':
+            source_image = arg
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '-t':
+            threads = int(arg)
+        elif opt == '--sizes':
+            size_list = [ tuple(int(v) for v in s.split('x')) for s in arg.split(',') ]
+        elif opt == '--engine':
+            engine = arg
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='integral_simd_')
+    atexit.register(shutil.rmtree, work, True)
+    for (build, flag) in builds:
+        folder = os.path.join(work, 'face_detector_'+build)
+        os.mkdir(folder)
+        os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+folder+'/"')
+        ret_v = os.system('cd "'+folder+'" && make host '+flag)
+        if ret_v != 0:
+            print('Cannot compile the face detector.\n')
+            sys.exit(2)
+        with open(os.path.join(folder, 'parameter.txt'),'w') as file:
+            file.write(str(scale_factor)+'\n')
+            file.write(str(int(shift_step))+'\n')
+
+    src_w, src_h, src = ReadPgm(source_image)
+    os.mkdir(os.path.join(work, 'frames'))
+
+    print('engine='+engine+' threads='+str(threads)+' sf='+str(scale_factor)+' ss='+str(shift_step)+', best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+    print('frame size    scalar ms/frame  simd ms/frame  speedup  same faces')
+    for (w, h) in size_list:
+        frame = os.path.join(work, 'frames', str(w)+'x'+str(h)+'.pgm')
+        WritePgm(frame, w, h, Resize(src, src_w, src_h, w, h))
+        ms = {}
+        faces = {}
+        for (build, flag) in builds:
+            runs = [ Run(os.path.join(work, 'face_detector_'+build), frame) for r in range(repeats) ]
+            ms[build] = min([ run[0] for run in runs ])
+            faces[build] = runs[0][1]
+        print('%-12s  %15.3f  %13.3f  %7.2f  %10s' % (str(w)+'x'+str(h), ms['scalar'], ms['simd'], ms['scalar']/ms['simd'], 'yes' if faces['scalar'] == faces['simd'] else 'NO'))
+
+# ms/frame and faces of one run
+def Run(folder, frame):
+    cmd = './facedetect_host.exe -i "'+frame+'" -n '+str(iterations)+' -t '+str(threads)+' -e '+engine
+    proc = subprocess.run(cmd, shell=True, cwd=folder, stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    faces = re.findall(r'face \d+: .*', proc.stdout)
+    return ms, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
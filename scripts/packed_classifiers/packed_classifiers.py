@@ -0,0 +1,109 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, shutil, subprocess, tempfile, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+engine_list = ['scalar', 'simd', 'simd16', 'stage']
+iterations = 20
+scale_factor = 1.2
+shift_step = 1
+layouts = [ ('tables', 'PACKED=0'), ('packed', 'PACKED=1') ]
+perf_events = 'L1-dcache-load-misses,LLC-load-misses'
+
+def usage():
+    print('This program compares the two layouts of the weak classifiers in the host build of the face detector: separate tables (make host PACKED=0, the default) and one 64-byte record per weak classifier (make host PACKED=1). Both are built in a temporary directory and run on the test images in ../testimages/ with each engine. The time per frame and per detection window are reported, and when the perf tool is installed, the L1 data cache and last-level cache load misses per window.\n\n')
+    print('\t./packed_classifiers.py\n')
+    print('Engines (scalar, simd, simd16, stage), iterations per image, scale factor and shift step can be given:\n')
+    print('\t./packed_classifiers.py --engines scalar,simd -n 50 --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, engine_list, iterations, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:',['help','engines=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '--engines':
+            engine_list = arg.split(',')
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='packed_classifiers_')
+    atexit.register(shutil.rmtree, work, True)
+    for (layout, flag) in layouts:
+        folder = os.path.join(work, 'face_detector_'+layout)
+        os.mkdir(folder)
+        os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+folder+'/"')
+        ret_v = os.system('cd "'+folder+'" && make host '+flag)
+        if ret_v != 0:
+            print('Cannot compile the face detector.\n')
+            sys.exit(2)
+        with open(os.path.join(folder, 'parameter.txt'),'w') as file:
+            file.write(str(scale_factor)+'\n')
+            file.write(str(int(shift_step))+'\n')
+
+    use_perf = shutil.which('perf') is not None
+    print('sf='+str(scale_factor)+' ss='+str(shift_step)+', '+str(iterations)+' iterations per image')
+    if not use_perf:
+        print('perf not found, the cache misses are not measured')
+    print('engine  layout  ms/frame  ns/window  L1D misses/window  LLC misses/window')
+    for engine in engine_list:
+        for (layout, flag) in layouts:
+            total_ms = 0.0
+            windows = 0.0
+            l1_misses = 0.0
+            llc_misses = 0.0
+            for k in range(image_number):
+                ms, w, l1, llc = Run(os.path.join(work, 'face_detector_'+layout), k, engine, use_perf)
+                total_ms += ms
+                windows += w
+                l1_misses += l1
+                llc_misses += llc
+            ns = total_ms*1e6/windows
+            if use_perf:
+                print('%-6s  %-6s  %8.3f  %9.2f  %17.2f  %17.3f' % (engine, layout, total_ms/image_number, ns, l1_misses/(windows*iterations), llc_misses/(windows*iterations)))
+            else:
+                print('%-6s  %-6s  %8.3f  %9.2f  %17s  %17s' % (engine, layout, total_ms/image_number, ns, 'n/a', 'n/a'))
+
+# ms/frame, windows/frame and cache misses of all frames of one run
+def Run(folder, k, engine, use_perf):
+    image = os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm')
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -e '+engine
+    if use_perf:
+        cmd = 'perf stat -x, -e '+perf_events+' '+cmd
+    proc = subprocess.run(cmd, shell=True, cwd=folder, stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    windows = float(re.search(r'([0-9]+) windows/frame', proc.stdout).group(1))
+    l1 = 0.0
+    llc = 0.0
+    if use_perf:
+        # perf -x, lines: count,unit,event,...
+        for line in proc.stderr.splitlines():
+            fields = line.split(',')
+            if len(fields) > 2 and fields[0].isdigit():
+                if fields[2].startswith('L1-dcache-load-misses'):
+                    l1 = float(fields[0])
+                elif fields[2].startswith('LLC-load-misses'):
+                    llc = float(fields[0])
+    return ms, windows, l1, llc
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,141 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+sys.path.insert(0, os.path.join(root, 'scripts'))
+from common import ReadPgm, WritePgm, Resize
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+source_image = '../testimages/Face_ori.pgm'
+large_size = (1920, 1080)
+iterations = 5
+repeats = 3
+engine = 'scalar'
+fractions = [ 1.0, 0.5, 0.25, 0.1 ]
+scale_factor = 1.2
+shift_step = 1
+
+def usage():
+    print('This program measures the regions of interest of the host build of the face detector (-r and -R), built in a temporary directory: only the windows lying inside a region are scanned, and the bands of the pyramid levels, with their integral image rows, cover those windows only. The test images in ../testimages/, Face.pgm and ../testimages/Face_ori.pgm resized to 1920x1080 are run with a centred rectangle covering a fraction of the frame area, and with a mask of two discs (its regions are their bounding boxes). For each image and region the windows per frame, the time per frame (best of several runs) and the candidate windows (before grouping) are reported, and the candidates are checked to be exactly those of the full scan lying inside the region.\n\n')
+    print('\t./region_of_interest.py\n')
+    print('Area fractions, iterations per run, runs, engine, large frame size, scale factor and shift step can be given:\n')
+    print('\t./region_of_interest.py --fractions 1,0.5,0.25,0.1 -n 5 -r 3 --engine scalar --size 1920x1080 --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, fractions, iterations, repeats, engine, large_size, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:r:',['help','fractions=','engine=','size=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '--fractions':
+            fractions = [ float(v) for v in arg.split(',') ]
+        elif opt == '--engine':
+            engine = arg
+        elif opt == '--size':
+            large_size = tuple(int(v) for v in arg.split('x'))
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='region_of_interest_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    images = [ os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm') for k in range(image_number) ] + [ os.path.join(root, 'Face.pgm') ]
+    src_w, src_h, src = ReadPgm(source_image)
+    (w, h) = large_size
+    os.mkdir(os.path.join(work, 'frames'))
+    frame = os.path.join(work, 'frames', str(w)+'x'+str(h)+'.pgm')
+    WritePgm(frame, w, h, Resize(src, src_w, src_h, w, h))
+    images.append(frame)
+
+    print('engine='+engine+' sf='+str(scale_factor)+' ss='+str(shift_step)+', best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+    print('image           region        windows/frame  ms/frame  speedup  candidates  exact')
+    for image in images:
+        (w, h) = ImageSize(image)
+        cases = []
+        for f in fractions:
+            rw = int(w*f**0.5)
+            rh = int(h*f**0.5)
+            rect = ((w - rw)//2, (h - rh)//2, rw, rh)
+            cases.append(('%.0f%% rect' % (100*f), '-r %d,%d,%d,%d' % rect, [ rect ]))
+        mask = os.path.join(work, 'frames', 'mask_'+str(w)+'x'+str(h)+'.pgm')
+        pixels, boxes = DiscMask(w, h)
+        WritePgm(mask, w, h, pixels)
+        cases.append(('mask', '-R "'+mask+'"', boxes))
+
+        runs = [ Run(image, '') for r in range(repeats) ]
+        base = (min([ run[0] for run in runs ]), runs[0][1], runs[0][2])
+        for (name, option, rects) in cases:
+            runs = [ Run(image, option) for r in range(repeats) ]
+            ms = min([ run[0] for run in runs ])
+            (windows, faces) = runs[0][1:]
+            expected = [ c for c in base[2] if any(Inside(c, r) for r in rects) ]
+            # the candidate list is cut at 127 windows, then the full scan cannot be compared
+            exact = 'n/a' if len(base[2]) >= 127 else ('yes' if sorted(expected) == sorted(faces) else 'NO')
+            print('%-14s  %-12s  %13d  %8.3f  %7.2f  %10d  %5s' % (os.path.basename(image), name, windows, ms, base[0]/ms, len(faces), exact))
+
+# the window r1 lies inside the rectangle r2
+def Inside(r1, r2):
+    return r1[0] >= r2[0] and r1[1] >= r2[1] and r1[0]+r1[2] <= r2[0]+r2[2] and r1[1]+r1[3] <= r2[1]+r2[3]
+
+# two discs in opposite quarters of the frame, and their bounding boxes
+def DiscMask(w, h):
+    pixels = bytearray(w*h)
+    boxes = []
+    for (cx, cy) in ((w//4, h//3), (3*w//4, 2*h//3)):
+        r = min(w, h)//5
+        x0, y0 = w, h
+        x1, y1 = 0, 0
+        for y in range(max(0, cy-r), min(h, cy+r)):
+            for x in range(max(0, cx-r), min(w, cx+r)):
+                if (x-cx)**2 + (y-cy)**2 < r*r:
+                    pixels[y*w + x] = 255
+                    x0, y0, x1, y1 = min(x0, x), min(y0, y), max(x1, x), max(y1, y)
+        boxes.append((x0, y0, x1-x0+1, y1-y0+1))
+    return bytes(pixels), boxes
+
+def ImageSize(image):
+    w, h, data = ReadPgm(image)
+    return w, h
+
+# ms/frame, windows/frame and candidates (x, y, w, h) of one run
+def Run(image, option):
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -e '+engine+' -m 0 '+option
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    windows = re.search(r'([0-9]+) windows/frame,', proc.stdout)
+    windows = int(windows.group(1)) if windows else 0
+    faces = [ tuple(int(v) for v in m) for m in re.findall(r'face \d+: x=(\d+) y=(\d+) w=(\d+) h=(\d+)', proc.stdout) ]
+    return ms, windows, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,94 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+sys.path.insert(0, os.path.join(root, 'scripts'))
+from common import ReadPgm, WritePgm, Resize
+work = '' # temporary directory it is built and run in, removed at exit
+source_image = '../testimages/Face_ori.pgm'
+size_list = [ (360,240), (640,480), (1280,720), (1920,1080), (2560,1440), (3840,2160) ]
+iterations = 5
+engine = 'scalar'
+threads = 1
+scale_factor = 1.2
+shift_step = 1
+
+def usage():
+    print('This program measures how the host build of the face detector (facedetect_host.exe) scales with the frame size. The source image (../testimages/Face_ori.pgm by default) is resized with nearest neighbour to each frame size, and for each size the time per frame, the time per megapixel, the number of faces and the peak resident memory of facedetect_host.exe are reported.\n\n')
+    print('\t./resolution_sweep.py\n')
+    print('Frame sizes, source image, iterations per size, engine (scalar, simd, simd16, stage), threads, scale factor and shift step can be given:\n')
+    print('\t./resolution_sweep.py --sizes 640x480,1920x1080,3840x2160 -i ../testimages/Face0.pgm -n 10 --engine simd -t 4 --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, source_image, size_list, iterations, engine, threads, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hi:n:t:',['help','sizes=','engine=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-i':
+            source_image = arg
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-t':
+            threads = int(arg)
+        elif opt == '--sizes':
+            size_list = [ tuple(int(v) for v in s.split('x')) for s in arg.split(',') ]
+        elif opt == '--engine':
+            engine = arg
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='resolution_sweep_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    src_w, src_h, src = ReadPgm(source_image)
+    os.mkdir(os.path.join(work, 'frames'))
+
+    print('engine='+engine+' threads='+str(threads)+' sf='+str(scale_factor)+' ss='+str(shift_step)+', '+str(iterations)+' iterations per size')
+    print('frame size    Mpixel  ms/frame  ms/Mpixel  faces  peak RSS (MB)')
+    for (w, h) in size_list:
+        frame = os.path.join(work, 'frames', str(w)+'x'+str(h)+'.pgm')
+        WritePgm(frame, w, h, Resize(src, src_w, src_h, w, h))
+        ms, faces, rss_kb = Run(frame)
+        mpix = w*h/1e6
+        print('%-12s  %6.2f  %8.3f  %9.3f  %5d  %13.1f' % (str(w)+'x'+str(h), mpix, ms, ms/mpix, faces, rss_kb/1024.0))
+
+def Run(frame):
+    cmd = ['./facedetect_host.exe', '-i', frame, '-n', str(iterations), '-t', str(threads), '-e', engine]
+    proc = subprocess.Popen(cmd, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    out = proc.stdout.read()
+    # the resource usage of this run only, ru_maxrss is in kB on Linux
+    pid, status, usage = os.wait4(proc.pid, 0)
+    proc.returncode = status
+    if status != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', out).group(1))
+    faces = len(re.findall(r'^face \d+:', out, re.M))
+    return ms, faces, usage.ru_maxrss
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
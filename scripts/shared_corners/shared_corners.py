@@ -0,0 +1,111 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image = os.path.join(root, 'Face.pgm')
+engine_list = ['simd', 'simd16', 'stage']
+iterations = 20
+repeats = 5
+scale_factor = 1.2
+shift_step = 2
+builds = [ ('direct', 'SHARED_CORNERS=0'), ('shared', 'SHARED_CORNERS=1') ]
+
+def usage():
+    print('This program measures the corners shared by the Haar features of a stage. For each stage of the cascade it lists the corner reads of its features (4 per rectangle, first 200 features as in runCascadeClassifier) and the distinct corners the gather kernels read instead. Then the host build of the face detector is built with every corner read per feature (make host SHARED_CORNERS=0) and with the distinct corners of a stage gathered once (the default), both in a temporary directory, and the time per frame on Face.pgm of both is reported for each engine (best of several runs). The gather kernels are the SIMD engines with a shift step above 1 and the stage-major engine; the SIMD engines with shift step 1 load the corners and are the same in both builds.\n\n')
+    print('\t./shared_corners.py\n')
+    print('Engines (simd, simd16, stage), iterations per run, runs, scale factor and shift step can be given:\n')
+    print('\t./shared_corners.py --engines simd16,stage -n 50 -r 5 --sf 1.2 --ss 2\n\n')
+
+def main(argv):
+    global work, engine_list, iterations, repeats, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:r:',['help','engines=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '--engines':
+            engine_list = arg.split(',')
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    CornerReport()
+
+    work = tempfile.mkdtemp(prefix='shared_corners_')
+    atexit.register(shutil.rmtree, work, True)
+    for (build, flag) in builds:
+        folder = os.path.join(work, 'face_detector_'+build)
+        os.mkdir(folder)
+        os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+folder+'/"')
+        ret_v = os.system('cd "'+folder+'" && make host '+flag)
+        if ret_v != 0:
+            print('Cannot compile the face detector.\n')
+            sys.exit(2)
+        with open(os.path.join(folder, 'parameter.txt'),'w') as file:
+            file.write(str(scale_factor)+'\n')
+            file.write(str(int(shift_step))+'\n')
+
+    print('\nFace.pgm, sf='+str(scale_factor)+' ss='+str(shift_step)+', best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+    print('engine  direct ms/frame  shared ms/frame  speedup')
+    for engine in engine_list:
+        ms = {}
+        for (build, flag) in builds:
+            ms[build] = min([ Run(os.path.join(work, 'face_detector_'+build), engine) for r in range(repeats) ])
+        print('%-6s  %15.3f  %15.3f  %7.2f' % (engine, ms['direct'], ms['shared'], ms['direct']/ms['shared']))
+
+# corner reads per window of each stage, per feature and with the shared corners
+def CornerReport():
+    rects = ReadTable(os.path.join(root, 'rectangles_array.dat'))
+    stages = ReadTable(os.path.join(root, 'stages_array.dat'))
+
+    print('stage  features  corner reads  distinct corners  reduction')
+    first = 0
+    total_reads = 0
+    total_corners = 0
+    for i in range(len(stages)):
+        n = min(stages[i], 200)
+        corners = set()
+        reads = 0
+        for j in range(first, first + n):
+            for k in range(3):
+                x, y, w, h = rects[12*j + 4*k : 12*j + 4*k + 4]
+                if k == 2 and (x, y, w, h) == (0, 0, 0, 0):
+                    continue
+                corners.update([ (x, y), (x + w, y), (x, y + h), (x + w, y + h) ])
+                reads += 4
+        print('%5d  %8d  %12d  %16d  %9.2f' % (i, n, reads, len(corners), reads/len(corners)))
+        total_reads += reads
+        total_corners += len(corners)
+        first += n
+    print('total  %8d  %12d  %16d  %9.2f' % (first, total_reads, total_corners, total_reads/total_corners))
+
+def ReadTable(filename):
+    with open(filename) as file:
+        return [ int(v) for v in re.findall(r'-?[0-9]+', file.read()) ]
+
+def Run(folder, engine):
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -e '+engine
+    proc = subprocess.run(cmd, shell=True, cwd=folder, stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    return float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,94 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+iterations = 30
+interval = 10
+engine = 'scalar'
+scale_factor = 1.2
+shift_step = 1
+
+def usage():
+    print('This program measures the temporal-coherence (video) mode of the host build of the face detector (facedetect_host.exe -k). Each test image in ../testimages/ is processed as a still video of n frames, once with a full scan of every frame and once with a full scan every k frames and a rescan around the previous faces in between. The time per frame of both runs is reported, with the faces of the last frame of the video mode that are not within 10% of a face of the full scan (and the other way around).\n\n')
+    print('\t./temporal_coherence.py\n')
+    print('Frames per image, full-scan interval, engine (scalar, simd, simd16, stage), scale factor and shift step can be given:\n')
+    print('\t./temporal_coherence.py -n 60 -k 15 --engine simd --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, iterations, interval, engine, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:k:',['help','engine=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-k':
+            interval = int(arg)
+        elif opt == '--engine':
+            engine = arg
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='temporal_coherence_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    print('engine='+engine+' sf='+str(scale_factor)+' ss='+str(shift_step)+', '+str(iterations)+' frames, full scan every '+str(interval))
+    print('image      full ms/frame  video ms/frame  speedup  faces  missed  extra')
+    full_total = 0.0
+    video_total = 0.0
+    for k in range(image_number):
+        full_ms, full_faces = Run(k, 0)
+        video_ms, video_faces = Run(k, interval)
+        missed = len([ r for r in full_faces if not Near(r, video_faces) ])
+        extra = len([ r for r in video_faces if not Near(r, full_faces) ])
+        full_total += full_ms
+        video_total += video_ms
+        print('Face%d.pgm  %13.3f  %14.3f  %7.2f  %5d  %6d  %5d' % (k, full_ms, video_ms, full_ms/video_ms, len(full_faces), missed, extra))
+    print('average    %13.3f  %14.3f  %7.2f' % (full_total/image_number, video_total/image_number, full_total/video_total))
+
+# r is within 10% of the size of a face in the list
+def Near(r, faces):
+    for f in faces:
+        tol = 0.1*f[2]
+        if abs(r[0]-f[0]) <= tol and abs(r[1]-f[1]) <= tol and abs(r[2]-f[2]) <= tol:
+            return True
+    return False
+
+def Run(k, track_interval):
+    image = os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm')
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -k '+str(track_interval)+' -e '+engine
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    faces = [ tuple(int(v) for v in m) for m in re.findall(r'face \d+: x=(\d+) y=(\d+) w=(\d+) h=\d+', proc.stdout) ]
+    return ms, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,88 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+thread_list = list(range(1, (os.cpu_count() or 1) + 1))
+iterations = 20
+engine = 'scalar'
+scale_factor = 1.2
+shift_step = 1
+
+def usage():
+    print('This program measures how the host build of the face detector (facedetect_host.exe) scales with the number of worker threads. It is built in a temporary directory and run on the test images in ../testimages/ with 1 to N threads (N = number of cores by default). For each thread count it reports the time per frame summed over the images, the speedup over 1 thread, and the utilization (share of the thread time spent in detection tasks, the rest is waiting for the last tasks of a frame) and the number of stolen tasks reported by the scheduler.\n\n')
+    print('\t./thread_scaling.py\n')
+    print('Thread counts, iterations per image, engine (scalar, simd, simd16, stage), scale factor and shift step can be given:\n')
+    print('\t./thread_scaling.py --threads 1,2,4,8,16,32 -n 50 --engine simd --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, thread_list, iterations, engine, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:',['help','threads=','engine=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '--threads':
+            thread_list = [ int(v) for v in arg.split(',') ]
+        elif opt == '--engine':
+            engine = arg
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='thread_scaling_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    print('engine='+engine+' sf='+str(scale_factor)+' ss='+str(shift_step)+', '+str(iterations)+' iterations per image')
+    print('threads  ms/frame  speedup  utilization  stolen/frame')
+    base = None
+    for threads in thread_list:
+        total_ms = 0.0
+        util = 0.0
+        stolen = 0.0
+        for k in range(image_number):
+            ms, u, s = Run(k, threads)
+            total_ms += ms
+            util += u
+            stolen += s
+        if base is None:
+            base = total_ms
+        print('%7d  %8.3f  %7.2f  %10.1f%%  %12.1f' % (threads, total_ms/image_number, base/total_ms, util/image_number, stolen/image_number))
+
+def Run(k, threads):
+    image = os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm')
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -t '+str(threads)+' -e '+engine
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    sched = re.search(r'utilization ([0-9.]+)%.* ([0-9.]+) stolen/frame', proc.stdout)
+    return ms, float(sched.group(1)), float(sched.group(2))
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,118 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, random, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+sys.path.insert(0, os.path.join(root, 'scripts'))
+from common import Agreed, ReadPgm, WritePgm
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+source_image = '../testimages/Face0.pgm'
+background_size = (1920, 1080)
+iterations = 5
+repeats = 3
+engine = 'scalar'
+floors = [ 0, 25, 100, 400 ]
+scale_factor = 1.2
+shift_step = 1
+overlap = 0.5
+
+def usage():
+    print('This program measures the variance floor of the host build of the face detector (-v), built in a temporary directory: the windows whose grey-level variance is below the floor are rejected from the squared integral image before any weak classifier runs. The test images in ../testimages/, Face.pgm and a synthetic frame (../testimages/Face0.pgm pasted on a flat, slightly noisy grey background of 1920x1080) are run with each floor. For each image and floor the windows skipped per frame, the time per frame (best of several runs) and the faces are reported, with the faces of floor 0 (no floor, the results of the facedetect module) still found (intersection over union of at least 0.5).\n\n')
+    print('\t./variance_floor.py\n')
+    print('Floors, iterations per run, runs, engine, background size, scale factor and shift step can be given:\n')
+    print('\t./variance_floor.py --floors 0,25,100,400 -n 5 -r 3 --engine scalar --size 1920x1080 --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, floors, iterations, repeats, engine, background_size, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:r:',['help','floors=','engine=','size=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '--floors':
+            floors = [ int(v) for v in arg.split(',') ]
+        elif opt == '--engine':
+            engine = arg
+        elif opt == '--size':
+            background_size = tuple(int(v) for v in arg.split('x'))
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+    if 0 not in floors:
+        floors.insert(0, 0)
+
+    work = tempfile.mkdtemp(prefix='variance_floor_')
+    atexit.register(shutil.rmtree, work, True)
+    os.mkdir(os.path.join(work, 'face_detector'))
+    os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+work+'/face_detector/"')
+    ret_v = os.system('cd "'+work+'/face_detector" && make host')
+    if ret_v != 0:
+        print('Cannot compile the face detector.\n')
+        sys.exit(2)
+
+    with open(work+'/face_detector/parameter.txt','w') as file:
+        file.write(str(scale_factor)+'\n')
+        file.write(str(int(shift_step))+'\n')
+
+    images = [ os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm') for k in range(image_number) ] + [ os.path.join(root, 'Face.pgm') ]
+    src_w, src_h, src = ReadPgm(source_image)
+    (w, h) = background_size
+    os.mkdir(os.path.join(work, 'frames'))
+    frame = os.path.join(work, 'frames', 'flat_'+str(w)+'x'+str(h)+'.pgm')
+    WritePgm(frame, w, h, FlatBackground(src, src_w, src_h, w, h))
+    images.append(frame)
+
+    print('engine='+engine+' sf='+str(scale_factor)+' ss='+str(shift_step)+', best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+    print('image                floor  windows/frame  skipped/frame  skipped %  ms/frame  speedup  faces  kept')
+    for image in images:
+        base = None
+        for floor in floors:
+            runs = [ Run(image, floor) for r in range(repeats) ]
+            ms = min([ run[0] for run in runs ])
+            (windows, skipped, faces) = runs[0][1:]
+            if base is None:
+                base = (ms, faces)
+            print('%-19s  %5d  %13d  %13d  %9.1f  %8.3f  %7.2f  %5d  %4d' % (os.path.basename(image), floor, windows, skipped, 100.0*skipped/windows, ms, base[0]/ms, len(faces), Agreed(base[1], faces, overlap)))
+
+# grey background with a little sensor noise, the source image in the middle
+def FlatBackground(src, src_w, src_h, w, h):
+    rng = random.Random(1)
+    pixels = bytearray(rng.randint(126, 130) for k in range(w*h))
+    x0 = max(0, (w - src_w)//2)
+    y0 = max(0, (h - src_h)//2)
+    cols = min(src_w, w)
+    for y in range(min(src_h, h)):
+        pixels[(y0+y)*w + x0:(y0+y)*w + x0 + cols] = src[y*src_w:y*src_w + cols]
+    return bytes(pixels)
+
+# ms/frame, windows/frame, skipped windows/frame and faces (x, y, w, h) of one run
+def Run(image, floor):
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -e '+engine+' -v '+str(floor)
+    proc = subprocess.run(cmd, shell=True, cwd=os.path.join(work, 'face_detector'), stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    windows = int(re.search(r'([0-9]+) windows/frame,', proc.stdout).group(1))
+    skipped = re.search(r'([0-9]+) windows/frame skipped', proc.stdout)
+    skipped = int(skipped.group(1)) if skipped else 0
+    faces = [ tuple(int(v) for v in m) for m in re.findall(r'face \d+: x=(\d+) y=(\d+) w=(\d+) h=(\d+)', proc.stdout) ]
+    return ms, windows, skipped, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
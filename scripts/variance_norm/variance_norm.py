@@ -0,0 +1,93 @@
+#! /usr/bin/env python3
+import os, sys, getopt, re, subprocess, tempfile, shutil, atexit
+
+root = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..')) # the repository the face detector is copied from
+work = '' # temporary directory it is built and run in, removed at exit
+image_number = 8 # test images Face0.pgm ... Face7.pgm
+iterations = 20
+repeats = 5
+engines = [ 'scalar', 'stage' ]
+scale_factor = 1.2
+shift_step = 1
+builds = [ ('window', 'SIMD_NORM=0'), ('row', 'SIMD_NORM=1') ]
+
+def usage():
+    print('This program compares the host build of the face detector computing variance_norm_factor one window at a time with the bit-serial int_sqrt (make host SIMD_NORM=0) and for a whole row of windows with AVX2 / AVX-512 (the default), both built in a temporary directory. Both run the scalar and the stage-major engines, which take the normalization from that step, on the test images in ../testimages/ and on Face.pgm. The time per frame and per detection window (best of several runs) are reported, and the faces of the two builds are checked to be the same.\n\n')
+    print('\t./variance_norm.py\n')
+    print('Iterations per run, runs, engines, scale factor and shift step can be given:\n')
+    print('\t./variance_norm.py -n 20 -r 5 --engines scalar,stage --sf 1.2 --ss 1\n\n')
+
+def main(argv):
+    global work, iterations, repeats, engines, scale_factor, shift_step
+
+    try:
+        opts, args = getopt.getopt(argv,'hn:r:',['help','engines=','sf=','ss='])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+
+    for opt, arg in opts:
+        if opt in ('-h','--help'):
+            usage()
+            sys.exit(0)
+        elif opt == '-n':
+            iterations = int(arg)
+        elif opt == '-r':
+            repeats = int(arg)
+        elif opt == '--engines':
+            engines = arg.split(',')
+        elif opt == '--sf':
+            scale_factor = float(arg)
+        elif opt == '--ss':
+            shift_step = int(arg)
+        else:
+            usage()
+            sys.exit(2)
+
+    work = tempfile.mkdtemp(prefix='variance_norm_')
+    atexit.register(shutil.rmtree, work, True)
+    for (build, flag) in builds:
+        folder = os.path.join(work, 'face_detector_'+build)
+        os.mkdir(folder)
+        os.system('cd "'+root+'" && cp *.h *.cpp *.inc *.dat Makefile "'+folder+'/"')
+        ret_v = os.system('cd "'+folder+'" && make host '+flag)
+        if ret_v != 0:
+            print('Cannot compile the face detector.\n')
+            sys.exit(2)
+        with open(os.path.join(folder, 'parameter.txt'),'w') as file:
+            file.write(str(scale_factor)+'\n')
+            file.write(str(int(shift_step))+'\n')
+
+    images = [ os.path.join(root, 'scripts', 'testimages', 'Face'+str(k)+'.pgm') for k in range(image_number) ] + [ os.path.join(root, 'Face.pgm') ]
+    for engine in engines:
+        print('engine='+engine+' sf='+str(scale_factor)+' ss='+str(shift_step)+', best of '+str(repeats)+' runs of '+str(iterations)+' frames')
+        print('image       per window ms/frame  ns/window  per row ms/frame  ns/window  speedup  same faces')
+        total = { 'window': 0.0, 'row': 0.0 }
+        for image in images:
+            ms = {}
+            ns = {}
+            faces = {}
+            for (build, flag) in builds:
+                runs = [ Run(os.path.join(work, 'face_detector_'+build), engine, image) for r in range(repeats) ]
+                ms[build] = min([ run[0] for run in runs ])
+                ns[build] = min([ run[1] for run in runs ])
+                faces[build] = runs[0][2]
+                total[build] += ms[build]
+            print('%-10s  %19.3f  %9.2f  %16.3f  %9.2f  %7.2f  %10s' % (os.path.basename(image), ms['window'], ns['window'], ms['row'], ns['row'], ms['window']/ms['row'], 'yes' if faces['window'] == faces['row'] else 'NO'))
+        print('total       %19.3f  %9s  %16.3f  %9s  %7.2f\n' % (total['window'], '', total['row'], '', total['window']/total['row']))
+
+# ms/frame, ns/window and faces of one run
+def Run(folder, engine, image):
+    cmd = './facedetect_host.exe -i "'+image+'" -n '+str(iterations)+' -e '+engine
+    proc = subprocess.run(cmd, shell=True, cwd=folder, stdout=subprocess.PIPE, universal_newlines=True)
+    if proc.returncode != 0:
+        print('Runtime error occur in facedetect_host.exe.')
+        sys.exit(2)
+
+    ms = float(re.search(r'([0-9.]+) ms/frame', proc.stdout).group(1))
+    ns = float(re.search(r'([0-9.]+) ns/window', proc.stdout).group(1))
+    faces = re.findall(r'face \d+: .*', proc.stdout)
+    return ms, ns, faces
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,73 @@
+//============================================================================================
+//
+// File Name    : spsc_queue.h
+// Description  : Lock-free single-producer single-consumer ring buffer (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Queue between the stages of facedetect_stream
+//18/10/2026  1.1       UTD DARClab                  Indices padded apart instead of over-aligned
+//============================================================================================
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <vector>
+#include <atomic>
+#include <stddef.h>
+
+/************************************************************
+ * spsc_queue:
+ * bounded FIFO for exactly one thread calling push and one
+ * thread calling pop. The producer only writes tail and
+ * the consumer only writes head, so no lock is needed: the
+ * release store of an index publishes the element before
+ * it, and the acquire load on the other side sees it.
+ ***********************************************************/
+template<typename T>
+class spsc_queue
+{
+public:
+    explicit spsc_queue(int capacity) : ring(capacity + 1), head(0), tail(0) {}
+
+    /* false when the queue is full */
+    bool push(const T& value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1 == ring.size()) ? 0 : t + 1;
+
+        if( next == head.load(std::memory_order_acquire) )
+            return false;
+        ring[t] = value;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /* false when the queue is empty */
+    bool pop(T* value)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+
+        if( h == tail.load(std::memory_order_acquire) )
+            return false;
+        *value = ring[h];
+        head.store((h + 1 == ring.size()) ? 0 : h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    /* the indices are kept a cache line apart by padding rather than
+       alignas, so the queue can be allocated with a plain new */
+    std::vector<T> ring; // one slot stays empty to tell a full queue from an empty one
+    char pad_head[64];
+    std::atomic<size_t> head; // next element to pop, written by the consumer
+    char pad_tail[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> tail; // next free slot, written by the producer
+    char pad_end[64 - sizeof(std::atomic<size_t>)];
+};
+
+#endif
@@ -0,0 +1,184 @@
+//============================================================================================
+//
+// File Name    : task_scheduler.cpp
+// Description  : Work-stealing scheduler for the detection tasks (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Per-thread deques with stealing
+//============================================================================================
+
+/****************************************************************
+ * The cost estimate only knows the number of windows of a task.
+ * How deep the windows go into the cascade depends on the image,
+ * so two bands with the same estimate can differ several times
+ * in run time. The initial deal balances the estimates, and the
+ * stealing corrects what the estimates get wrong. The deques are
+ * short (a few tasks per thread), so a mutex per deque is cheap
+ * compared to a task.
+ ***************************************************************/
+
+#include "task_scheduler.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+task_scheduler::task_scheduler()
+{
+    task_cost = NULL;
+    resetStats();
+}
+
+task_scheduler::~task_scheduler()
+{
+    int t;
+
+    for( t = 0; t < (int)queues.size(); t++ )
+        delete queues[t];
+}
+
+void task_scheduler::resetStats(void)
+{
+    stats.runs = 0;
+    stats.tasks = 0;
+    stats.stolen = 0;
+    stats.wall_time = 0;
+    stats.busy_time = 0;
+    stats.thread_time = 0;
+}
+
+void task_scheduler::getStats(SchedulerStats* s) const
+{
+    *s = stats;
+}
+
+int task_scheduler::nextTask(int t, bool* stolen)
+{
+    int k, v, victim;
+    long most;
+
+    {
+        std::lock_guard<std::mutex> guard(queues[t]->lock);
+        if( !queues[t]->tasks.empty() )
+        {
+            k = queues[t]->tasks.front();
+            queues[t]->tasks.pop_front();
+            queues[t]->cost_left -= (*task_cost)[k];
+            *stolen = false;
+            return k;
+        }
+    }
+
+    /* own deque is empty: steal the last task of the busiest thread */
+    for( ;; )
+    {
+        victim = -1;
+        most = -1;
+        for( v = 0; v < (int)queues.size(); v++ )
+        {
+            if( v != t )
+            {
+                std::lock_guard<std::mutex> guard(queues[v]->lock);
+                if( !queues[v]->tasks.empty() && queues[v]->cost_left > most )
+                {
+                    victim = v;
+                    most = queues[v]->cost_left;
+                }
+            }
+        }
+        if( victim < 0 )
+            return -1;
+
+        std::lock_guard<std::mutex> guard(queues[victim]->lock);
+        /* it may have been emptied since it was looked at */
+        if( !queues[victim]->tasks.empty() )
+        {
+            k = queues[victim]->tasks.back();
+            queues[victim]->tasks.pop_back();
+            queues[victim]->cost_left -= (*task_cost)[k];
+            *stolen = true;
+            return k;
+        }
+    }
+}
+
+void task_scheduler::worker(int t, const std::function<void(int, int)>& task)
+{
+    int k;
+    bool stolen;
+    long ntasks = 0, nstolen = 0;
+    double busy = 0;
+
+    while( (k = nextTask(t, &stolen)) >= 0 )
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        task(t, k);
+        busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ntasks++;
+        if( stolen )
+            nstolen++;
+    }
+
+    std::lock_guard<std::mutex> guard(stats_lock);
+    stats.tasks += ntasks;
+    stats.stolen += nstolen;
+    stats.busy_time += busy;
+}
+
+void task_scheduler::run(int nthreads, const std::vector<long>& cost, const std::function<void(int, int)>& task)
+{
+    int i, t;
+    int ntasks = cost.size();
+    std::vector<int> order(ntasks);
+    std::vector<std::thread> pool;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if( nthreads < 1 )
+        nthreads = 1;
+    while( (int)queues.size() < nthreads )
+        queues.push_back(new TaskQueue());
+    while( (int)queues.size() > nthreads )
+    {
+        delete queues.back();
+        queues.pop_back();
+    }
+    task_cost = &cost;
+
+    /* largest first, each task to the thread with the least estimated work */
+    for( i = 0; i < ntasks; i++ )
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&cost](int a, int b) { return cost[a] > cost[b]; });
+
+    for( t = 0; t < nthreads; t++ )
+    {
+        queues[t]->tasks.clear();
+        queues[t]->cost_left = 0;
+    }
+    for( i = 0; i < ntasks; i++ )
+    {
+        int least = 0;
+        for( t = 1; t < nthreads; t++ )
+        {
+            if( queues[t]->cost_left < queues[least]->cost_left )
+                least = t;
+        }
+        queues[least]->tasks.push_back(order[i]);
+        queues[least]->cost_left += cost[order[i]];
+    }
+
+    for( t = 1; t < nthreads; t++ )
+        pool.push_back(std::thread(&task_scheduler::worker, this, t, std::cref(task)));
+    worker(0, task);
+    for( t = 0; t < (int)pool.size(); t++ )
+        pool[t].join();
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.runs++;
+    stats.wall_time += wall;
+    stats.thread_time += wall*nthreads;
+    task_cost = NULL;
+}
@@ -0,0 +1,74 @@
+//============================================================================================
+//
+// File Name    : task_scheduler.h
+// Description  : Work-stealing scheduler for the detection tasks (host build)
+// Release Date : 17/10/2026
+// Author       : Jianqi Chen, Benjamin Carrion Schafer
+//
+// Revision History
+//--------------------------------------------------------------------------------------------
+// Date       Version   Author                       Description
+//--------------------------------------------------------------------------------------------
+//17/10/2026  1.0       UTD DARClab                  Per-thread deques with stealing
+//============================================================================================
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <functional>
+
+/* accumulated over all calls to task_scheduler::run */
+struct SchedulerStats
+{
+    int runs;           // calls to run
+    long tasks;         // tasks executed
+    long stolen;        // tasks taken from another thread's deque
+    double wall_time;   // seconds from the start of run to the last join, summed
+    double busy_time;   // seconds spent inside the tasks, summed over all threads
+    double thread_time; // wall_time times the number of threads
+};
+
+/************************************************************
+ * task_scheduler:
+ * runs tasks 0 to ntasks-1 on nthreads threads (the calling
+ * thread is thread 0). The tasks are dealt to per-thread
+ * deques by their estimated cost, largest first, each to
+ * the least loaded thread. A thread works from the front of
+ * its own deque and, when it is empty, steals from the back
+ * of the deque with the most estimated work left.
+ ***********************************************************/
+class task_scheduler
+{
+public:
+    task_scheduler();
+    ~task_scheduler();
+
+    /* task(thread, k) is called once for every k; returns when all are done */
+    void run(int nthreads, const std::vector<long>& cost, const std::function<void(int, int)>& task);
+
+    void getStats(SchedulerStats* stats) const;
+    void resetStats(void);
+
+private:
+    struct TaskQueue
+    {
+        std::mutex lock;
+        std::deque<int> tasks;
+        long cost_left;       // estimated cost of the tasks still in the deque
+    };
+
+    std::vector<TaskQueue*> queues;
+    const std::vector<long>* task_cost;
+    SchedulerStats stats;
+    std::mutex stats_lock;
+
+    /* next task of thread t, from its own deque or stolen; -1 when there is none */
+    int nextTask(int t, bool* stolen);
+
+    void worker(int t, const std::function<void(int, int)>& task);
+};
+
+#endif
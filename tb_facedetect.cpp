@@ -10,6 +10,7 @@
 // Date     Version   Author                            Description
 //--------------------------------------------------------------------------------------------
 //25/03/2019  1.0   UTD DARClab                         face detector testbench 
+//17/10/2026  1.1   UTD DARClab                         check the image size read from the header
 //============================================================================================
 
 #include "define.h"
@@ -43,6 +44,12 @@ void test_FACEDETECT::test_main ()
         printf( "Unable to open input image\n");
         sc_stop();
     }
+    if (image->width != IMAGE_WIDTH || image->height != IMAGE_HEIGHT)
+    {
+        printf("ERROR: the facedetect module takes %d x %d images, Face.pgm is %d x %d\n", IMAGE_WIDTH, IMAGE_HEIGHT, image->width, image->height);
+        sc_stop();
+        return;
+    }
 
     wait();
     printf("-- sending data --\r\n");